@@ -14,6 +14,8 @@ public class OnlinePlatformSteam : GameModule
         base.Setup(options);
 
         options.PublicDependencies.Add("Online");
+        options.PublicDependencies.Add("Networking");
         options.PrivateDependencies.Add("Steamworks");
+        options.PrivateDependencies.Add("LZ4");
     }
 }
@@ -3,9 +3,17 @@
 #if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
 
 #include "OnlinePlatformSteam.h"
+#include "SteamHelpers.h"
+#include "SteamSaveGame.h"
+#include "SteamPersonaCache.h"
+#include "SteamAvatarCache.h"
+#include "SteamRichPresence.h"
+#include "SteamPingLocation.h"
+#include "SteamNetworkDriver.h"
 #include "Engine/Content/Content.h"
 #include "Engine/Content/JsonAsset.h"
 #include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
 #include "Engine/Core/Types/TimeSpan.h"
 #include "Engine/Core/Config/GameSettings.h"
 #include "Engine/Core/Collections/Array.h"
@@ -18,6 +26,7 @@
 #include "Engine/Platform/File.h"
 #endif
 #include <Steamworks/steam_api.h>
+#include <Steamworks/steam_gameserver.h>
 
 IMPLEMENT_GAME_SETTINGS_GETTER(SteamSettings, "Steam");
 
@@ -75,6 +84,19 @@ OnlinePresenceStates GetUserPresence(EPersonaState state)
     }
 }
 
+// True if platform runs as Steam dedicated game server
+static bool GameServerMode = false;
+
+ISteamNetworkingSockets* GetNetworkingSockets()
+{
+    return GameServerMode ? SteamGameServerNetworkingSockets() : SteamNetworkingSockets();
+}
+
+ISteamNetworkingMessages* GetNetworkingMessages()
+{
+    return GameServerMode ? SteamGameServerNetworkingMessages() : SteamNetworkingMessages();
+}
+
 OnlineLeaderboardSortModes GetLeaderboardSortMode(ELeaderboardSortMethod value)
 {
     switch (value)
@@ -135,6 +157,92 @@ ELeaderboardDisplayType GetLeaderboardValueFormat(OnlineLeaderboardValueFormats
     return k_ELeaderboardDisplayTypeNone;
 }
 
+class SteamCallbacks
+{
+public:
+    OnlinePlatformSteam* Platform;
+
+    SteamCallbacks(OnlinePlatformSteam* platform)
+        : Platform(platform)
+    {
+    }
+
+private:
+    STEAM_CALLBACK(SteamCallbacks, OnPersonaStateChange, PersonaStateChange_t);
+    STEAM_CALLBACK(SteamCallbacks, OnAvatarImageLoaded, AvatarImageLoaded_t);
+    STEAM_CALLBACK(SteamCallbacks, OnFriendRichPresenceUpdate, FriendRichPresenceUpdate_t);
+    STEAM_CALLBACK(SteamCallbacks, OnRelayNetworkStatus, SteamRelayNetworkStatus_t);
+    STEAM_CALLBACK(SteamCallbacks, OnServersConnected, SteamServersConnected_t);
+};
+
+void SteamCallbacks::OnPersonaStateChange(PersonaStateChange_t* data)
+{
+    Platform->_personaCache->OnPersonaStateChange(data->m_ulSteamID, data->m_nChangeFlags);
+    if (data->m_nChangeFlags & k_EPersonaChangeAvatar)
+        Platform->_avatarCache->OnAvatarChanged(data->m_ulSteamID);
+}
+
+void SteamCallbacks::OnAvatarImageLoaded(AvatarImageLoaded_t* data)
+{
+    Platform->_avatarCache->OnAvatarImageLoaded(data->m_steamID.ConvertToUint64(), data->m_iImage, data->m_iWide, data->m_iTall);
+}
+
+void SteamCallbacks::OnFriendRichPresenceUpdate(FriendRichPresenceUpdate_t* data)
+{
+    Platform->_friendsRichPresence->Invalidate(data->m_steamIDFriend.ConvertToUint64());
+}
+
+void SteamCallbacks::OnRelayNetworkStatus(SteamRelayNetworkStatus_t* data)
+{
+    Platform->OnRelayNetworkStatus(*data);
+}
+
+void SteamCallbacks::OnServersConnected(SteamServersConnected_t* data)
+{
+    // Persona changes are not reported while logged off so rebuild the friends list after logging on again
+    Platform->_personaCache->Invalidate();
+}
+
+class SteamGameServerCallbacks
+{
+public:
+    OnlinePlatformSteam* Platform;
+
+    SteamGameServerCallbacks(OnlinePlatformSteam* platform)
+        : Platform(platform)
+    {
+    }
+
+private:
+    STEAM_GAMESERVER_CALLBACK(SteamGameServerCallbacks, OnServersConnected, SteamServersConnected_t);
+    STEAM_GAMESERVER_CALLBACK(SteamGameServerCallbacks, OnServerConnectFailure, SteamServerConnectFailure_t);
+    STEAM_GAMESERVER_CALLBACK(SteamGameServerCallbacks, OnServersDisconnected, SteamServersDisconnected_t);
+    STEAM_GAMESERVER_CALLBACK(SteamGameServerCallbacks, OnRelayNetworkStatus, SteamRelayNetworkStatus_t);
+};
+
+void SteamGameServerCallbacks::OnServersConnected(SteamServersConnected_t* data)
+{
+    LOG(Info, "Steam game server logged on (SteamID: {0})", Platform->_steamGameServer->GetSteamID().ConvertToUint64());
+    Platform->GameServerConnected(true);
+}
+
+void SteamGameServerCallbacks::OnServerConnectFailure(SteamServerConnectFailure_t* data)
+{
+    LOG(Warning, "Steam game server failed to log on (result: {0}{1})", (int32)data->m_eResult, data->m_bStillRetrying ? TEXT(", retrying") : TEXT(""));
+    Platform->GameServerConnected(false);
+}
+
+void SteamGameServerCallbacks::OnServersDisconnected(SteamServersDisconnected_t* data)
+{
+    LOG(Warning, "Steam game server disconnected (result: {0})", (int32)data->m_eResult);
+    Platform->GameServerConnected(false);
+}
+
+void SteamGameServerCallbacks::OnRelayNetworkStatus(SteamRelayNetworkStatus_t* data)
+{
+    Platform->OnRelayNetworkStatus(*data);
+}
+
 template <typename Result>
 bool WaitForCall(ISteamUtils* steamUtils, SteamAPICall_t call, Result& result)
 {
@@ -182,6 +290,9 @@ bool OnlinePlatformSteam::Initialize()
     File::WriteAllText(steamAppIdFile, StringUtils::ToString(appId), Encoding::ANSI);
 #endif
 
+    if (settings->GameServer)
+        return InitializeGameServer(settings, appId);
+
     // Give Steam a chance to relaunch a game via Steam App
     if (SteamAPI_RestartAppIfNecessary(appId))
     {
@@ -206,6 +317,26 @@ bool OnlinePlatformSteam::Initialize()
 #undef GET_STEAM_API
 
     _steamClient->SetWarningMessageHook(&SteamAPIDebugTextHook);
+    _personaCache = New<SteamPersonaCache>(_steamFriends);
+    _richPresence = New<SteamRichPresenceWriter>(_steamFriends, settings->RichPresenceUpdateInterval);
+    _friendsRichPresence = New<SteamRichPresenceCache>(_steamFriends);
+    if (ISteamNetworkingUtils* networkingUtils = SteamNetworkingUtils())
+        _pingLocations = New<SteamPingLocationService>(networkingUtils);
+    _avatarCache = New<SteamAvatarCache>(_steamFriends, _steamUtils, (int64)Math::Max(settings->AvatarCacheSize, 1) * 1024 * 1024, settings->AvatarAtlasSize);
+    _callbacks = New<SteamCallbacks>(this);
+    _saveGameCompressionThreshold = settings->CompressSaveGame ? Math::Max(settings->CompressSaveGameThreshold, 0) : -1;
+    _asyncSaveGame = settings->AsyncSaveGame;
+    if (_asyncSaveGame && StartSaveGameWorker())
+    {
+        LOG(Warning, "Failed to start Steam savegame worker, using synchronous saves");
+    }
+    if (settings->NetworkImpairment.Enabled)
+    {
+        LOG(Warning, "Steam network impairment simulation is enabled");
+        SteamNetworkDriver::SetImpairment(settings->NetworkImpairment);
+    }
+    if (settings->RelayNetworkWarmup)
+        InitRelayNetworkAccess();
     Engine::LateUpdate.Bind<OnlinePlatformSteam, &OnlinePlatformSteam::OnUpdate>(this);
 
     return false;
@@ -215,6 +346,29 @@ void OnlinePlatformSteam::Deinitialize()
 {
     if (!_steamClient)
         return;
+    if (_saveGameWorker)
+    {
+        // Write all pending savegames before shutting down Steam
+        _saveGameWorker->Shutdown();
+        Array<SteamSaveGameWorker::BatchResult> results;
+        _saveGameWorker->PopCompletedBatches(results);
+        for (const auto& result : results)
+            SaveGamesWritten(result.Id, result.Failed);
+        Delete(_saveGameWorker);
+        _saveGameWorker = nullptr;
+    }
+    SAFE_DELETE(_callbacks);
+    SAFE_DELETE(_gameServerCallbacks);
+    SAFE_DELETE(_personaCache);
+    SAFE_DELETE(_avatarCache);
+    if (_richPresence)
+    {
+        // Send the latest rich presence (updates are throttled)
+        _richPresence->Flush(true);
+        SAFE_DELETE(_richPresence);
+    }
+    SAFE_DELETE(_friendsRichPresence);
+    SAFE_DELETE(_pingLocations);
     _steamClient = nullptr;
     _steamUser = nullptr;
     _steamFriends = nullptr;
@@ -222,9 +376,22 @@ void OnlinePlatformSteam::Deinitialize()
     _steamRemoteStorage = nullptr;
     _steamUtils = nullptr;
     _hasCurrentStats = false;
+    _relayNetworkReady = false;
+    _relayNetworkReadiness = 0.0f;
     _hasModifiedStats = false;
     Engine::LateUpdate.Unbind<OnlinePlatformSteam, &OnlinePlatformSteam::OnUpdate>(this);
-    SteamAPI_Shutdown();
+    if (_steamGameServer)
+    {
+        _steamGameServer->SetAdvertiseServerActive(false);
+        _steamGameServer->LogOff();
+        _steamGameServer = nullptr;
+        SteamGameServer_Shutdown();
+        GameServerMode = false;
+    }
+    else
+    {
+        SteamAPI_Shutdown();
+    }
 }
 
 bool OnlinePlatformSteam::UserLogin(User* localUser)
@@ -262,16 +429,7 @@ bool OnlinePlatformSteam::GetFriends(Array<OnlineUser>& friends, User* localUser
 {
     if (_steamUser && _steamUser->BLoggedOn())
     {
-        const int32 friendsCount = _steamFriends->GetFriendCount(k_EFriendFlagImmediate);
-        friends.Resize(friendsCount);
-        for (int32 i = 0; i < friendsCount; i++)
-        {
-            auto& user = friends[i];
-            const CSteamID friendId = _steamFriends->GetFriendByIndex(i, k_EFriendFlagImmediate);
-            user.Id = GetUserId(friendId);
-            user.Name = _steamFriends->GetFriendPersonaName(friendId);
-            user.PresenceState = GetUserPresence(_steamFriends->GetFriendPersonaState(friendId));
-        }
+        friends = _personaCache->GetFriends();
         return false;
     }
     return true;
@@ -454,46 +612,336 @@ bool OnlinePlatformSteam::GetSaveGame(const StringView& name, Array<byte, HeapAl
     PROFILE_CPU();
     if (_steamRemoteStorage)
     {
-        const StringAsANSI<> nameStr(name.Get(), name.Length());
-        data.Clear();
-        if (_steamRemoteStorage->FileExists(nameStr.Get()))
+        // Pending write holds the most recent data
+        if (_saveGameWorker && _saveGameWorker->TryGetPending(name, data))
+            return false;
+        return SteamSaveGame::Read(_steamRemoteStorage, name, data);
+    }
+    return true;
+}
+
+bool OnlinePlatformSteam::SetSaveGame(const StringView& name, const Span<byte>& data, User* localUser)
+{
+    PROFILE_CPU();
+    if (_steamRemoteStorage)
+    {
+        if (_saveGameWorker)
         {
-            const int32 size = _steamRemoteStorage->GetFileSize(nameStr.Get());
-            if (size > 0)
+            if (_asyncSaveGame)
             {
-                data.Resize(size);
-                const int32 read = _steamRemoteStorage->FileRead(nameStr.Get(), data.Get(), size);
-                if (read != size)
-                {
-                    data.Clear();
-                    return true;
-                }
+                _saveGameWorker->Enqueue(name, data);
+                return false;
             }
+
+            // Worker was started only for multi-file saves so write pending files first to keep writes in order
+            _saveGameWorker->Flush();
         }
-        return false;
+        return SteamSaveGame::Write(_steamRemoteStorage, name, data, _saveGameCompressionThreshold);
     }
     return true;
 }
 
-bool OnlinePlatformSteam::SetSaveGame(const StringView& name, const Span<byte>& data, User* localUser)
+bool OnlinePlatformSteam::SetSaveGames(const Array<SteamSaveGameFile>& files, uint32& batchId)
 {
     PROFILE_CPU();
-    if (_steamRemoteStorage)
+    batchId = 0;
+    if (_steamRemoteStorage && files.HasItems())
     {
-        const StringAsANSI<> nameStr(name.Get(), name.Length());
-        if (data.Length() > 0)
+        // Multi-file saves are always asynchronous
+        if (!_saveGameWorker && StartSaveGameWorker())
+            return true;
+        batchId = ++_saveGameBatchId;
+        _saveGameWorker->EnqueueBatch(batchId, files);
+        return false;
+    }
+    return true;
+}
+
+uint32 OnlinePlatformSteam::GetFriendsVersion() const
+{
+    return _personaCache ? _personaCache->GetVersion() : 0;
+}
+
+bool OnlinePlatformSteam::UpdateFriends(Array<OnlineUser>& friends, uint32& version)
+{
+    if (_steamUser && _steamUser->BLoggedOn())
+    {
+        const Array<OnlineUser>& cached = _personaCache->GetFriends();
+        if (version == _personaCache->GetVersion())
+            return false;
+        version = _personaCache->GetVersion();
+        friends.Resize(cached.Count());
+        for (int32 i = 0; i < cached.Count(); i++)
         {
-            // Write
-            return !_steamRemoteStorage->FileWrite(nameStr.Get(), data.Get(), data.Length());
+            auto& user = friends[i];
+            const auto& cachedUser = cached[i];
+            user.Id = cachedUser.Id;
+            if (user.Name != cachedUser.Name)
+                user.Name = cachedUser.Name;
+            user.PresenceState = cachedUser.PresenceState;
         }
-        else if (_steamRemoteStorage->FileExists(nameStr.Get()))
+        return true;
+    }
+
+    // Logged off user has no friends (version is reset so the list gets updated after logging on)
+    const bool modified = friends.HasItems();
+    friends.Clear();
+    version = 0;
+    return modified;
+}
+
+StringView OnlinePlatformSteam::GetFriendName(const Guid& userId)
+{
+    return _personaCache ? _personaCache->GetName(GetSteamId(userId).ConvertToUint64()) : StringView::Empty;
+}
+
+bool OnlinePlatformSteam::GetAvatar(const Guid& userId, SteamAvatarSize size, SteamAvatar& avatar)
+{
+    if (_avatarCache)
+        return _avatarCache->Get(GetSteamId(userId).ConvertToUint64(), size, avatar);
+    return true;
+}
+
+bool OnlinePlatformSteam::SetRichPresence(const StringView& key, const StringView& value)
+{
+    return !_richPresence || _richPresence->Set(key, value);
+}
+
+bool OnlinePlatformSteam::SetRichPresenceDisplay(const StringView& token, const Dictionary<String, String>& variables)
+{
+    if (!_richPresence)
+        return true;
+    bool failed = false;
+    for (const auto& e : variables)
+        failed |= _richPresence->Set(e.Key, e.Value);
+    failed |= _richPresence->Set(TEXT("steam_display"), token);
+    return failed;
+}
+
+void OnlinePlatformSteam::ClearRichPresence()
+{
+    if (_richPresence)
+        _richPresence->Clear();
+}
+
+void OnlinePlatformSteam::GetFriendsRichPresence(const Array<Guid>& users, const Array<String>& keys, Array<String>& values)
+{
+    PROFILE_CPU();
+    values.Resize(users.Count() * keys.Count());
+    if (!_friendsRichPresence)
+        return;
+    Array<int32, InlinedAllocation<16>> keyIds;
+    keyIds.Resize(keys.Count());
+    for (int32 i = 0; i < keys.Count(); i++)
+        keyIds[i] = _friendsRichPresence->GetKeyId(keys[i]);
+    for (int32 userIndex = 0; userIndex < users.Count(); userIndex++)
+    {
+        const uint64 steamId = GetSteamId(users[userIndex]).ConvertToUint64();
+        String* userValues = values.Get() + userIndex * keys.Count();
+        for (int32 i = 0; i < keyIds.Count(); i++)
         {
-            // Delete
-            return !_steamRemoteStorage->FileDelete(nameStr.Get());
+            const StringView value = _friendsRichPresence->Get(steamId, keyIds[i]);
+            if (userValues[i] != value)
+                userValues[i] = value;
         }
-        return false;
     }
-    return true;
+}
+
+StringView OnlinePlatformSteam::GetFriendRichPresence(const Guid& userId, const StringView& key)
+{
+    if (_friendsRichPresence)
+        return _friendsRichPresence->Get(GetSteamId(userId).ConvertToUint64(), _friendsRichPresence->GetKeyId(key));
+    return StringView::Empty;
+}
+
+bool OnlinePlatformSteam::IsGameServerLoggedOn() const
+{
+    return _steamGameServer && _steamGameServer->BLoggedOn();
+}
+
+uint64 OnlinePlatformSteam::GetGameServerSteamId() const
+{
+    return IsGameServerLoggedOn() ? _steamGameServer->GetSteamID().ConvertToUint64() : 0;
+}
+
+void OnlinePlatformSteam::SetGameServerName(const StringView& name)
+{
+    if (!_steamGameServer)
+        return;
+    const StringAsANSI<> nameStr(name.Get(), name.Length());
+    _steamGameServer->SetServerName(nameStr.Get());
+}
+
+void OnlinePlatformSteam::SetGameServerMap(const StringView& map)
+{
+    if (!_steamGameServer)
+        return;
+    const StringAsANSI<> mapStr(map.Get(), map.Length());
+    _steamGameServer->SetMapName(mapStr.Get());
+}
+
+void OnlinePlatformSteam::SetGameServerPlayers(int32 maxPlayers, int32 botPlayers)
+{
+    if (!_steamGameServer)
+        return;
+    _steamGameServer->SetMaxPlayerCount(Math::Max(maxPlayers, 0));
+    _steamGameServer->SetBotPlayerCount(Math::Max(botPlayers, 0));
+}
+
+void OnlinePlatformSteam::SetGameServerKeyValue(const StringView& key, const StringView& value)
+{
+    if (!_steamGameServer)
+        return;
+    const StringAsANSI<> keyStr(key.Get(), key.Length());
+    const StringAsANSI<> valueStr(value.Get(), value.Length());
+    _steamGameServer->SetKeyValue(keyStr.Get(), valueStr.Get());
+}
+
+void OnlinePlatformSteam::ClearGameServerKeyValues()
+{
+    if (_steamGameServer)
+        _steamGameServer->ClearAllKeyValues();
+}
+
+void OnlinePlatformSteam::InitRelayNetworkAccess()
+{
+    ISteamNetworkingUtils* networkingUtils = SteamNetworkingUtils();
+    if (!_steamClient || !networkingUtils)
+        return;
+    networkingUtils->InitRelayNetworkAccess();
+
+    // Status changes are reported via callback but the network can be already initialized
+    SteamRelayNetworkStatus_t status;
+    networkingUtils->GetRelayNetworkStatus(&status);
+    OnRelayNetworkStatus(status);
+}
+
+bool OnlinePlatformSteam::GetPingLocation(String& location)
+{
+    return !_pingLocations || _pingLocations->GetLocal(location);
+}
+
+int32 OnlinePlatformSteam::EstimatePing(const StringView& location)
+{
+    return _pingLocations ? _pingLocations->EstimatePing(location) : -1;
+}
+
+int32 OnlinePlatformSteam::EstimatePingBetween(const StringView& locationA, const StringView& locationB)
+{
+    return _pingLocations ? _pingLocations->EstimatePing(locationA, locationB) : -1;
+}
+
+void OnlinePlatformSteam::EstimatePings(const Array<String>& locations, Array<int32>& pings)
+{
+    if (_pingLocations)
+    {
+        _pingLocations->EstimatePings(locations, pings);
+    }
+    else
+    {
+        pings.Resize(locations.Count(), false);
+        for (int32& ping : pings)
+            ping = -1;
+    }
+}
+
+void OnlinePlatformSteam::RankHostsByPing(const Array<String>& locations, Array<int32>& ranking, Array<int32>& pings)
+{
+    if (_pingLocations)
+    {
+        _pingLocations->Rank(locations, ranking, pings);
+    }
+    else
+    {
+        EstimatePings(locations, pings);
+        ranking.Resize(locations.Count(), false);
+        for (int32 i = 0; i < ranking.Count(); i++)
+            ranking[i] = i;
+    }
+}
+
+bool OnlinePlatformSteam::InitializeGameServer(const SteamSettings* settings, uint32 appId)
+{
+    // Without Steam client the game server reads the app identifier from the environment
+    if (appId)
+    {
+        const String appIdStr = StringUtils::ToString(appId);
+        Platform::SetEnvironmentVariable(TEXT("SteamAppId"), appIdStr);
+        Platform::SetEnvironmentVariable(TEXT("SteamGameId"), appIdStr);
+    }
+
+    // Init Steam game server API
+    if (settings->GameServerQueryPort == settings->GameServerPort)
+    {
+        LOG(Error, "Steam game server query port has to be different from the game server port ({0})", settings->GameServerPort);
+        return true;
+    }
+    const StringAsANSI<> version(settings->GameServerVersion.Get(), settings->GameServerVersion.Length());
+    const EServerMode serverMode = settings->GameServerSecure ? eServerModeAuthenticationAndSecure : eServerModeAuthentication;
+    if (!SteamGameServer_Init(0, settings->GameServerPort, settings->GameServerQueryPort, serverMode, version.Get()))
+    {
+        LOG(Error, "SteamGameServer init failed");
+        return true;
+    }
+    _steamGameServer = SteamGameServer();
+    _steamClient = SteamGameServerClient();
+    _steamUtils = SteamGameServerUtils();
+    if (!_steamGameServer || !_steamClient || !_steamUtils)
+    {
+        LOG(Error, "Failed to get SteamGameServer interfaces");
+        _steamGameServer = nullptr;
+        _steamClient = nullptr;
+        _steamUtils = nullptr;
+        SteamGameServer_Shutdown();
+        return true;
+    }
+    GameServerMode = true;
+
+    // Server browser info has to be set before logging on
+    _steamClient->SetWarningMessageHook(&SteamAPIDebugTextHook);
+    const StringAsANSI<> product(settings->GameServerProduct.Get(), settings->GameServerProduct.Length());
+    const StringAsANSI<> description(settings->GameServerDescription.Get(), settings->GameServerDescription.Length());
+    _steamGameServer->SetModDir(product.Get());
+    _steamGameServer->SetProduct(product.Get());
+    _steamGameServer->SetGameDescription(description.Get());
+    _steamGameServer->SetDedicatedServer(true);
+    _gameServerCallbacks = New<SteamGameServerCallbacks>(this);
+    if (settings->GameServerLoginToken.HasChars())
+    {
+        const StringAsANSI<> token(settings->GameServerLoginToken.Get(), settings->GameServerLoginToken.Length());
+        _steamGameServer->LogOn(token.Get());
+    }
+    else
+    {
+        _steamGameServer->LogOnAnonymous();
+    }
+    _steamGameServer->SetAdvertiseServerActive(true);
+
+    if (ISteamNetworkingUtils* networkingUtils = SteamNetworkingUtils())
+        _pingLocations = New<SteamPingLocationService>(networkingUtils);
+    if (settings->NetworkImpairment.Enabled)
+    {
+        LOG(Warning, "Steam network impairment simulation is enabled");
+        SteamNetworkDriver::SetImpairment(settings->NetworkImpairment);
+    }
+    if (settings->RelayNetworkWarmup)
+        InitRelayNetworkAccess();
+    Engine::LateUpdate.Bind<OnlinePlatformSteam, &OnlinePlatformSteam::OnUpdate>(this);
+    LOG(Info, "Initialized Steam game server on port {0} (query port {1})", settings->GameServerPort, settings->GameServerQueryPort);
+
+    return false;
+}
+
+bool OnlinePlatformSteam::StartSaveGameWorker()
+{
+    _saveGameWorker = New<SteamSaveGameWorker>(_steamRemoteStorage, _saveGameCompressionThreshold);
+    if (_saveGameWorker->Start())
+    {
+        Delete(_saveGameWorker);
+        _saveGameWorker = nullptr;
+        return true;
+    }
+    return false;
 }
 
 bool OnlinePlatformSteam::RequestCurrentStats()
@@ -579,14 +1027,70 @@ bool OnlinePlatformSteam::GetLeaderboardEntries(SteamAPICall_t call, Array<Onlin
 
 void OnlinePlatformSteam::OnUpdate()
 {
+    if (_steamGameServer)
+    {
+        // Game server has no user services
+        SteamGameServer_RunCallbacks();
+        return;
+    }
+
+    if (_saveGameWorker)
+    {
+        // Report completed multi-file saves
+        Array<SteamSaveGameWorker::BatchResult> results;
+        _saveGameWorker->PopCompletedBatches(results);
+        for (const auto& result : results)
+            SaveGamesWritten(result.Id, result.Failed);
+    }
+
     // TODO: delay StoreStats calls frequency to be once a minute or so
     if (_hasModifiedStats)
     {
         _hasModifiedStats = false;
         _steamUserStats->StoreStats();
     }
+    _richPresence->Flush();
+
+    // Collect friends list changes reported by the callbacks below
+    _personaCache->CollectChanges = FriendsChanged.IsBinded();
 
     SteamAPI_RunCallbacks();
+
+    // Send friends list changes
+    if (_personaCache->CollectChanges)
+    {
+        Array<SteamFriendChange> changes;
+        _personaCache->PopChanges(changes);
+        if (changes.HasItems())
+            FriendsChanged(changes);
+    }
+
+    // Upload loaded avatars
+    Array<Pair<uint64, SteamAvatarSize>> avatars;
+    _avatarCache->Update(avatars);
+    for (const auto& e : avatars)
+        AvatarLoaded(GetUserId(CSteamID(e.First)), e.Second);
+}
+
+void OnlinePlatformSteam::OnRelayNetworkStatus(const SteamRelayNetworkStatus_t& status)
+{
+    // Readiness steps: network config fetched, any relay reachable, relays pings measured
+    const bool hasConfig = status.m_eAvailNetworkConfig == k_ESteamNetworkingAvailability_Current;
+    const bool hasRelay = status.m_eAvailAnyRelay == k_ESteamNetworkingAvailability_Current;
+    const bool hasPings = hasRelay && !status.m_bPingMeasurementInProgress;
+    _relayNetworkReadiness = ((hasConfig ? 1.0f : 0.0f) + (hasRelay ? 1.0f : 0.0f) + (hasPings ? 1.0f : 0.0f)) / 3.0f;
+
+    const bool wasReady = _relayNetworkReady;
+    _relayNetworkReady = status.m_eAvail == k_ESteamNetworkingAvailability_Current && hasPings;
+    if (_relayNetworkReady && !wasReady)
+    {
+        LOG(Info, "Steam relay network is ready");
+        RelayNetworkReady();
+    }
+    else if (status.m_eAvail == k_ESteamNetworkingAvailability_Failed)
+    {
+        LOG(Warning, "Steam relay network access failed: {0}", String(status.m_debugMsg));
+    }
 }
 
 #endif
@@ -5,9 +5,134 @@
 #if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
 
 #include "Engine/Core/Config/Settings.h"
+#include "Engine/Core/Delegate.h"
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Math/Rectangle.h"
 #include "Engine/Online/IOnlinePlatform.h"
 #include "Engine/Scripting/ScriptingObject.h"
 
+class GPUTexture;
+
+/// <summary>
+/// The Steam network connection lane configuration. Messages sent on a higher priority lane always go before lower priority ones, while lanes with the same priority share the bandwidth by their weights.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkLane
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkLane);
+
+    /// <summary>
+    /// The lane priority. Lower value means higher priority.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 Priority = 0;
+
+    /// <summary>
+    /// The lane weight used to share the bandwidth with the other lanes of the same priority.
+    /// </summary>
+    API_FIELD(Attributes="Limit(1, 65535)") int32 Weight = 1;
+
+    /// <summary>
+    /// If checked, messages sent on this lane are compressed with LZ4 (only when it makes them smaller). Adds 1 byte header to every message on the lane (5 bytes for messages compressed with the dictionary). All peers need to use the same setting.
+    /// </summary>
+    API_FIELD() bool Compression = false;
+
+    /// <summary>
+    /// The minimum message size (in bytes) to compress. Smaller messages are sent raw.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0), VisibleIf(nameof(Compression))") int32 CompressionThreshold = 128;
+
+public:
+    SteamNetworkLane() = default;
+
+    SteamNetworkLane(int32 priority, int32 weight = 1)
+        : Priority(priority)
+        , Weight(weight)
+    {
+    }
+};
+
+/// <summary>
+/// The Steam network connection send rate and Nagle policy. Used to tune the connections for the game traffic (eg. frequent small state updates or bulk transfers).
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkSendRate
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkSendRate);
+
+    /// <summary>
+    /// The minimum send rate (in bytes per second). Use 0 to keep the Steam default.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 SendRateMin = 0;
+
+    /// <summary>
+    /// The maximum send rate (in bytes per second). Use 0 to keep the Steam default.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 SendRateMax = 0;
+
+    /// <summary>
+    /// The time (in milliseconds) that small messages are delayed to be combined into a single packet. Use 0 to send messages immediately.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0, 1000)") float NagleTime = 5.0f;
+
+    /// <summary>
+    /// If checked, the send rate is adjusted automatically within the minimum and maximum send rate: raised while the queue time stays low and lowered when it grows over the target. Updated 10 times per second, independently from the network stats sampling.
+    /// </summary>
+    API_FIELD() bool Adaptive = false;
+
+    /// <summary>
+    /// The target queue time (in milliseconds) of the adaptive send rate controller.
+    /// </summary>
+    API_FIELD(Attributes="Limit(1), VisibleIf(nameof(Adaptive))") float TargetQueueTime = 20.0f;
+};
+
+/// <summary>
+/// The Steam networking impairment simulation profile. Used to test the game under bad network conditions (packet loss, lag and reordering) without real network.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkImpairment
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkImpairment);
+
+    /// <summary>
+    /// If checked, the impairment is applied to all Steam connections on startup.
+    /// </summary>
+    API_FIELD() bool Enabled = false;
+
+    /// <summary>
+    /// The percentage of the outgoing packets to drop (0-100).
+    /// </summary>
+    API_FIELD(Attributes="Limit(0, 100)") float PacketLossSend = 0.0f;
+
+    /// <summary>
+    /// The percentage of the incoming packets to drop (0-100).
+    /// </summary>
+    API_FIELD(Attributes="Limit(0, 100)") float PacketLossRecv = 0.0f;
+
+    /// <summary>
+    /// The extra delay (in milliseconds) of the outgoing packets.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 PacketLagSend = 0;
+
+    /// <summary>
+    /// The extra delay (in milliseconds) of the incoming packets.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 PacketLagRecv = 0;
+
+    /// <summary>
+    /// The percentage of the outgoing packets to reorder (0-100).
+    /// </summary>
+    API_FIELD(Attributes="Limit(0, 100)") float PacketReorderSend = 0.0f;
+
+    /// <summary>
+    /// The percentage of the incoming packets to reorder (0-100).
+    /// </summary>
+    API_FIELD(Attributes="Limit(0, 100)") float PacketReorderRecv = 0.0f;
+
+    /// <summary>
+    /// The extra delay (in milliseconds) of the reordered packets.
+    /// </summary>
+    API_FIELD(Attributes="Limit(0)") int32 PacketReorderTime = 15;
+};
+
 /// <summary>
 /// The settings for Steam online platform.
 /// </summary>
@@ -20,6 +145,204 @@ public:
     // App ID of the game.
     API_FIELD(Attributes="EditorOrder(0)")
     uint32 AppId = 0;
+
+    // If checked, SetSaveGame queues the data and returns immediately while the background worker thread writes it to the Steam Cloud. Multiple saves to the same slot are merged so only the latest one gets written.
+    API_FIELD(Attributes="EditorOrder(100), EditorDisplay(\"Cloud Saves\")")
+    bool AsyncSaveGame = false;
+
+    // If checked, savegames are compressed before upload to the Steam Cloud. Savegames written without compression can still be loaded.
+    API_FIELD(Attributes="EditorOrder(110), EditorDisplay(\"Cloud Saves\")")
+    bool CompressSaveGame = false;
+
+    // The minimum savegame size (in bytes) to use compression. Smaller savegames are stored raw.
+    API_FIELD(Attributes="EditorOrder(120), EditorDisplay(\"Cloud Saves\"), Limit(0), VisibleIf(nameof(CompressSaveGame))")
+    int32 CompressSaveGameThreshold = 1024;
+
+    // The maximum memory size (in megabytes) of the cached users avatars. Least recently used avatars are released when the limit is exceeded.
+    API_FIELD(Attributes="EditorOrder(200), EditorDisplay(\"Avatars\"), Limit(1)")
+    int32 AvatarCacheSize = 16;
+
+    // The size (in pixels) of the texture atlas used to pack users avatars (one per avatar size). Use 0 to create a separate texture for every avatar.
+    API_FIELD(Attributes="EditorOrder(210), EditorDisplay(\"Avatars\"), Limit(0, 4096)")
+    int32 AvatarAtlasSize = 1024;
+
+    // The minimum time interval (in seconds) between rich presence updates sent to Steam. Changes made within the interval are merged.
+    API_FIELD(Attributes="EditorOrder(300), EditorDisplay(\"Rich Presence\"), Limit(0)")
+    float RichPresenceUpdateInterval = 1.0f;
+
+    // The Steam network driver lane used by the unreliable channel. By default unreliable lanes have higher priority than reliable ones so time-critical state updates are not queued behind bulk reliable data.
+    API_FIELD(Attributes="EditorOrder(400), EditorDisplay(\"Networking\")")
+    SteamNetworkLane UnreliableLane = SteamNetworkLane(0);
+
+    // The Steam network driver lane used by the unreliable ordered channel.
+    API_FIELD(Attributes="EditorOrder(410), EditorDisplay(\"Networking\")")
+    SteamNetworkLane UnreliableOrderedLane = SteamNetworkLane(0);
+
+    // The Steam network driver lane used by the reliable channel.
+    API_FIELD(Attributes="EditorOrder(420), EditorDisplay(\"Networking\")")
+    SteamNetworkLane ReliableLane = SteamNetworkLane(1);
+
+    // The Steam network driver lane used by the reliable ordered channel.
+    API_FIELD(Attributes="EditorOrder(430), EditorDisplay(\"Networking\")")
+    SteamNetworkLane ReliableOrderedLane = SteamNetworkLane(1);
+
+    // If checked, Steam network driver runs the networking callbacks, receives and sends messages on a dedicated thread. The game thread only swaps the received and sent messages buffers.
+    API_FIELD(Attributes="EditorOrder(440), EditorDisplay(\"Networking\")")
+    bool NetworkThread = false;
+
+    // The time interval (in seconds) between samples of Steam network connections statistics (published to the profiler and the connection stats history). Use 0 to disable sampling.
+    API_FIELD(Attributes="EditorOrder(450), EditorDisplay(\"Networking\"), Limit(0)")
+    float NetworkStatsInterval = 0.5f;
+
+    // The time period (in seconds) of the Steam network connections statistics history.
+    API_FIELD(Attributes="EditorOrder(460), EditorDisplay(\"Networking\"), Limit(0)")
+    float NetworkStatsHistory = 10.0f;
+
+    // The network impairment simulation profile. Can be changed at runtime with SteamNetworkDriver.SetImpairment.
+    API_FIELD(Attributes="EditorOrder(470), EditorDisplay(\"Networking\")")
+    SteamNetworkImpairment NetworkImpairment;
+
+    // If checked, Steam network driver connects server and clients within the same process without Steam and without network (eg. for automated tests). Clients connect to the server listening on the same port and the address is ignored.
+    API_FIELD(Attributes="EditorOrder(480), EditorDisplay(\"Networking\")")
+    bool NetworkLoopback = false;
+
+    // If checked, access to Steam Datagram Relay network is initialized on startup so relays pings get measured in the background and the first P2P connection doesn't stall on it. Otherwise, it gets initialized on the first use (or via InitRelayNetworkAccess).
+    API_FIELD(Attributes="EditorOrder(490), EditorDisplay(\"Networking\")")
+    bool RelayNetworkWarmup = true;
+
+    // The send rate and Nagle policy of the Steam network driver connections. Can be changed per connection with SteamNetworkDriver.SetConnectionSendRate.
+    API_FIELD(Attributes="EditorOrder(500), EditorDisplay(\"Networking\")")
+    SteamNetworkSendRate NetworkSendRate;
+
+    // If checked, the platform initializes as Steam dedicated game server (without Steam client and local user). Used by headless servers.
+    API_FIELD(Attributes="EditorOrder(600), EditorDisplay(\"Game Server\")")
+    bool GameServer = false;
+
+    // The game server UDP port (used for game traffic and server browser).
+    API_FIELD(Attributes="EditorOrder(610), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    uint16 GameServerPort = 27015;
+
+    // The game server UDP port used for server browser queries. Has to be different from the game server port.
+    API_FIELD(Attributes="EditorOrder(620), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    uint16 GameServerQueryPort = 27016;
+
+    // The game server version (in the format x.x.x.x). Used by Steam to detect outdated servers.
+    API_FIELD(Attributes="EditorOrder(630), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    String GameServerVersion = TEXT("1.0.0.0");
+
+    // The game product name (also used as mod directory) reported to the server browser.
+    API_FIELD(Attributes="EditorOrder(640), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    String GameServerProduct;
+
+    // The game description reported to the server browser.
+    API_FIELD(Attributes="EditorOrder(650), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    String GameServerDescription;
+
+    // If checked, the game server is VAC secured.
+    API_FIELD(Attributes="EditorOrder(660), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    bool GameServerSecure = true;
+
+    // The game server login token (GSLT) used to log on a persistent account. Leave empty to log on anonymously.
+    API_FIELD(Attributes="EditorOrder(670), EditorDisplay(\"Game Server\"), VisibleIf(nameof(GameServer))")
+    String GameServerLoginToken;
+};
+
+/// <summary>
+/// The savegame file description used for multi-file cloud saves.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamSaveGameFile
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamSaveGameFile);
+
+    /// <summary>
+    /// The savegame name.
+    /// </summary>
+    API_FIELD() String Name;
+
+    /// <summary>
+    /// The savegame contents. Empty data deletes the savegame.
+    /// </summary>
+    API_FIELD() Array<byte> Data;
+};
+
+/// <summary>
+/// The types of the friend changes.
+/// </summary>
+API_ENUM(Namespace="FlaxEngine.Online.Steam", Attributes="Flags") enum class SteamFriendChanges
+{
+    // No changes.
+    None = 0,
+    // User has been added to the friends list.
+    Added = 1 << 0,
+    // User has been removed from the friends list.
+    Removed = 1 << 1,
+    // Friend presence state changed (eg. came online).
+    Presence = 1 << 2,
+    // Friend name changed.
+    Name = 1 << 3,
+    // Friend started or stopped playing a game.
+    GamePlayed = 1 << 4,
+};
+
+DECLARE_ENUM_OPERATORS(SteamFriendChanges);
+
+/// <summary>
+/// The friends list change description.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamFriendChange
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamFriendChange);
+
+    /// <summary>
+    /// The friend (current state).
+    /// </summary>
+    API_FIELD() OnlineUser User;
+
+    /// <summary>
+    /// The changes that happened to the friend.
+    /// </summary>
+    API_FIELD() SteamFriendChanges Changes = SteamFriendChanges::None;
+};
+
+/// <summary>
+/// The sizes of the Steam user avatar image.
+/// </summary>
+API_ENUM(Namespace="FlaxEngine.Online.Steam") enum class SteamAvatarSize
+{
+    // Small avatar (32x32 pixels).
+    Small,
+    // Medium avatar (64x64 pixels).
+    Medium,
+    // Large avatar (184x184 pixels).
+    Large,
+};
+
+/// <summary>
+/// The Steam user avatar image. Might be packed into a texture atlas shared with other avatars.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamAvatar
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamAvatar);
+
+    /// <summary>
+    /// The texture with the avatar image (RGBA).
+    /// </summary>
+    API_FIELD() GPUTexture* Texture = nullptr;
+
+    /// <summary>
+    /// The normalized texture coordinates of the avatar image within the texture.
+    /// </summary>
+    API_FIELD() Rectangle UVs = Rectangle(0.0f, 0.0f, 1.0f, 1.0f);
+
+    /// <summary>
+    /// The avatar image width (in pixels).
+    /// </summary>
+    API_FIELD() int32 Width = 0;
+
+    /// <summary>
+    /// The avatar image height (in pixels).
+    /// </summary>
+    API_FIELD() int32 Height = 0;
 };
 
 /// <summary>
@@ -28,6 +351,8 @@ public:
 API_CLASS(Sealed, Namespace="FlaxEngine.Online.Steam") class ONLINEPLATFORMSTEAM_API OnlinePlatformSteam : public ScriptingObject, public IOnlinePlatform
 {
     DECLARE_SCRIPTING_TYPE(OnlinePlatformSteam);
+    friend class SteamCallbacks;
+    friend class SteamGameServerCallbacks;
 private:
     class ISteamClient* _steamClient = nullptr;
     class ISteamUser* _steamUser = nullptr;
@@ -35,8 +360,228 @@ private:
     class ISteamUserStats* _steamUserStats = nullptr;
     class ISteamRemoteStorage* _steamRemoteStorage = nullptr;
     class ISteamUtils* _steamUtils = nullptr;
+    class ISteamGameServer* _steamGameServer = nullptr;
+    class SteamSaveGameWorker* _saveGameWorker = nullptr;
+    class SteamPersonaCache* _personaCache = nullptr;
+    class SteamAvatarCache* _avatarCache = nullptr;
+    class SteamRichPresenceWriter* _richPresence = nullptr;
+    class SteamRichPresenceCache* _friendsRichPresence = nullptr;
+    class SteamPingLocationService* _pingLocations = nullptr;
+    class SteamCallbacks* _callbacks = nullptr;
+    class SteamGameServerCallbacks* _gameServerCallbacks = nullptr;
     bool _hasCurrentStats = false;
+    bool _relayNetworkReady = false;
+    float _relayNetworkReadiness = 0.0f;
     bool _hasModifiedStats = false;
+    uint32 _saveGameBatchId = 0;
+    int32 _saveGameCompressionThreshold = -1;
+    bool _asyncSaveGame = false;
+
+public:
+    /// <summary>
+    /// Event called when the multi-file savegame write started via SetSaveGames completes. Args: batch identifier, true if failed to write any of the files. Called on a main thread.
+    /// </summary>
+    API_EVENT() Delegate<uint32, bool> SaveGamesWritten;
+
+    /// <summary>
+    /// Event called when the friends list changes (eg. friend came online or changed name). Changes are batched and reported once per frame (multiple changes of the same friend are merged). Called on a main thread.
+    /// </summary>
+    API_EVENT() Delegate<const Array<SteamFriendChange, HeapAllocation>&> FriendsChanged;
+
+    /// <summary>
+    /// Event called when the user avatar requested via GetAvatar gets loaded. Args: user identifier, avatar size. Called on a main thread.
+    /// </summary>
+    API_EVENT() Delegate<const Guid&, SteamAvatarSize> AvatarLoaded;
+
+    /// <summary>
+    /// Event called when the Steam Datagram Relay network becomes ready (relays pings are measured so P2P connections and ping estimation can be used without delay). Called on a main thread.
+    /// </summary>
+    API_EVENT() Action RelayNetworkReady;
+
+    /// <summary>
+    /// Event called when the game server connection to Steam changes (see SteamSettings.GameServer). Args: true if logged on, false if disconnected or failed to log on. Called on a main thread.
+    /// </summary>
+    API_EVENT() Delegate<bool> GameServerConnected;
+
+    /// <summary>
+    /// Writes multiple savegames within a single Steam Cloud write batch to keep the set consistent. Data is copied and written asynchronously on a background thread.
+    /// </summary>
+    /// <param name="files">The savegame files to write.</param>
+    /// <param name="batchId">The output identifier of the batch, passed to SaveGamesWritten event once the write completes.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() bool SetSaveGames(const Array<SteamSaveGameFile, HeapAllocation>& files, API_PARAM(Out) uint32& batchId);
+
+    /// <summary>
+    /// Gets the version of the cached friends list. Changes whenever any friend is added, removed or changes the persona (name, presence). Can be used to skip processing of the unchanged friends list.
+    /// </summary>
+    API_PROPERTY() uint32 GetFriendsVersion() const;
+
+    /// <summary>
+    /// Updates the friends list only if it changed since the given version. Existing list items are overwritten in place to reuse the memory.
+    /// </summary>
+    /// <param name="friends">The friends list to update.</param>
+    /// <param name="version">The version of the friends list (0 on the first call). Updated to the latest version.</param>
+    /// <returns>True if friends list has been modified, otherwise false.</returns>
+    API_FUNCTION() bool UpdateFriends(API_PARAM(Ref) Array<OnlineUser, HeapAllocation>& friends, API_PARAM(Ref) uint32& version);
+
+    /// <summary>
+    /// Gets the cached name of the friend without allocating memory. Returned view is valid until the friends list version changes.
+    /// </summary>
+    /// <param name="userId">The friend user identifier.</param>
+    /// <returns>The friend name or empty if user is not a friend.</returns>
+    StringView GetFriendName(const Guid& userId);
+
+    /// <summary>
+    /// Gets the user avatar image. If avatar is not cached, it gets loaded in the background and AvatarLoaded event is called once it's ready.
+    /// </summary>
+    /// <param name="userId">The user identifier.</param>
+    /// <param name="size">The avatar size.</param>
+    /// <param name="avatar">The output avatar image.</param>
+    /// <returns>True if avatar is not yet available, otherwise false.</returns>
+    API_FUNCTION() bool GetAvatar(const Guid& userId, SteamAvatarSize size, API_PARAM(Out) SteamAvatar& avatar);
+
+    /// <summary>
+    /// Sets the local user rich presence value. Only modified keys are sent to Steam and updates are throttled (see SteamSettings.RichPresenceUpdateInterval), so it's fine to call it every frame.
+    /// </summary>
+    /// <param name="key">The rich presence key (eg. 'status' or 'steam_display').</param>
+    /// <param name="value">The value. Empty value removes the key.</param>
+    /// <returns>True if failed (eg. invalid key or value, or too many keys), otherwise false.</returns>
+    API_FUNCTION() bool SetRichPresence(const StringView& key, const StringView& value);
+
+    /// <summary>
+    /// Sets the localized rich presence display string (steam_display) with its substitution variables. Token must be defined in the game rich presence localization file.
+    /// </summary>
+    /// <param name="token">The localization token (eg. '#Status_InMatch').</param>
+    /// <param name="variables">The substitution variables used by the token (eg. 'map' for '%map%').</param>
+    /// <returns>True if failed (eg. invalid key or value, or too many keys), otherwise false.</returns>
+    API_FUNCTION() bool SetRichPresenceDisplay(const StringView& token, const Dictionary<String, String, HeapAllocation>& variables);
+
+    /// <summary>
+    /// Removes all local user rich presence keys.
+    /// </summary>
+    API_FUNCTION() void ClearRichPresence();
+
+    /// <summary>
+    /// Gets the rich presence values of multiple friends at once. Values are cached and refreshed only when Steam reports the friend rich presence change.
+    /// </summary>
+    /// <param name="users">The friends identifiers.</param>
+    /// <param name="keys">The rich presence keys to get.</param>
+    /// <param name="values">The output values laid out per user (value of key k for user u is at index u * keys.Count + k). Empty if key is not set.</param>
+    API_FUNCTION() void GetFriendsRichPresence(const Array<Guid, HeapAllocation>& users, const Array<String, HeapAllocation>& keys, API_PARAM(Out) Array<String, HeapAllocation>& values);
+
+    /// <summary>
+    /// Gets the cached friend rich presence value without allocating memory. Returned view is valid until the friend rich presence changes.
+    /// </summary>
+    /// <param name="userId">The friend identifier.</param>
+    /// <param name="key">The rich presence key.</param>
+    /// <returns>The value or empty if key is not set.</returns>
+    StringView GetFriendRichPresence(const Guid& userId, const StringView& key);
+
+    /// <summary>
+    /// Checks if the platform runs as Steam dedicated game server (see SteamSettings.GameServer). User related functions are unavailable in this mode.
+    /// </summary>
+    API_PROPERTY() bool IsGameServer() const
+    {
+        return _steamGameServer != nullptr;
+    }
+
+    /// <summary>
+    /// Checks if the game server is logged on to Steam.
+    /// </summary>
+    API_FUNCTION() bool IsGameServerLoggedOn() const;
+
+    /// <summary>
+    /// Gets the game server SteamID. Clients use it as the server address of the Steam network driver.
+    /// </summary>
+    /// <returns>The SteamID or 0 if game server is not logged on.</returns>
+    API_FUNCTION() uint64 GetGameServerSteamId() const;
+
+    /// <summary>
+    /// Sets the game server name visible in the server browser.
+    /// </summary>
+    API_FUNCTION() void SetGameServerName(const StringView& name);
+
+    /// <summary>
+    /// Sets the game server map name visible in the server browser.
+    /// </summary>
+    API_FUNCTION() void SetGameServerMap(const StringView& map);
+
+    /// <summary>
+    /// Sets the game server players limit and the amount of bots reported to the server browser.
+    /// </summary>
+    /// <param name="maxPlayers">The maximum amount of players.</param>
+    /// <param name="botPlayers">The amount of bot players.</param>
+    API_FUNCTION() void SetGameServerPlayers(int32 maxPlayers, int32 botPlayers = 0);
+
+    /// <summary>
+    /// Sets the game server key-value reported to the server browser (eg. game mode).
+    /// </summary>
+    /// <param name="key">The key.</param>
+    /// <param name="value">The value.</param>
+    API_FUNCTION() void SetGameServerKeyValue(const StringView& key, const StringView& value);
+
+    /// <summary>
+    /// Removes all game server key-values.
+    /// </summary>
+    API_FUNCTION() void ClearGameServerKeyValues();
+
+    /// <summary>
+    /// Starts the initialization of the Steam Datagram Relay network access (done in the background). Not needed if SteamSettings.RelayNetworkWarmup is enabled.
+    /// </summary>
+    API_FUNCTION() void InitRelayNetworkAccess();
+
+    /// <summary>
+    /// Checks if the Steam Datagram Relay network is ready (see RelayNetworkReady event).
+    /// </summary>
+    API_PROPERTY() bool IsRelayNetworkReady() const
+    {
+        return _relayNetworkReady;
+    }
+
+    /// <summary>
+    /// Gets the Steam Datagram Relay network initialization progress (0-1). Can be displayed while waiting for matchmaking.
+    /// </summary>
+    API_PROPERTY() float GetRelayNetworkReadiness() const
+    {
+        return _relayNetworkReadiness;
+    }
+
+    /// <summary>
+    /// Gets the local ping location string. It can be published to other players (eg. in the lobby data or rich presence) to estimate the latency between them without sending any packets.
+    /// </summary>
+    /// <param name="location">The output ping location string.</param>
+    /// <returns>True if location is not yet available (relay network is not ready), otherwise false.</returns>
+    API_FUNCTION() bool GetPingLocation(API_PARAM(Out) String& location);
+
+    /// <summary>
+    /// Estimates the round-trip time from the local host to the remote host with the given ping location. Parsed locations are cached.
+    /// </summary>
+    /// <param name="location">The remote host ping location string.</param>
+    /// <returns>The estimated ping (in milliseconds) or -1 if unknown.</returns>
+    API_FUNCTION() int32 EstimatePing(const StringView& location);
+
+    /// <summary>
+    /// Estimates the round-trip time between two hosts with the given ping locations (eg. to pick a host for other players).
+    /// </summary>
+    /// <param name="locationA">The first host ping location string.</param>
+    /// <param name="locationB">The second host ping location string.</param>
+    /// <returns>The estimated ping (in milliseconds) or -1 if unknown.</returns>
+    API_FUNCTION() int32 EstimatePingBetween(const StringView& locationA, const StringView& locationB);
+
+    /// <summary>
+    /// Estimates the round-trip times from the local host to many remote hosts at once.
+    /// </summary>
+    /// <param name="locations">The remote hosts ping location strings.</param>
+    /// <param name="pings">The output estimated pings (in milliseconds, -1 if unknown) in the locations order.</param>
+    API_FUNCTION() void EstimatePings(const Array<String, HeapAllocation>& locations, API_PARAM(Out) Array<int32, HeapAllocation>& pings);
+
+    /// <summary>
+    /// Ranks the candidate hosts by the estimated round-trip time from the local host. Hosts with unknown ping go last.
+    /// </summary>
+    /// <param name="locations">The candidate hosts ping location strings.</param>
+    /// <param name="ranking">The output indices of the hosts (in the locations list) ordered from the lowest ping.</param>
+    /// <param name="pings">The output estimated pings (in milliseconds, -1 if unknown) in the locations order.</param>
+    API_FUNCTION() void RankHostsByPing(const Array<String, HeapAllocation>& locations, API_PARAM(Out) Array<int32, HeapAllocation>& ranking, API_PARAM(Out) Array<int32, HeapAllocation>& pings);
 
 public:
     // [IOnlinePlatform]
@@ -67,10 +612,13 @@ public:
 
 private:
     bool RequestCurrentStats();
+    bool StartSaveGameWorker();
     bool GetLeaderboard(uint64 call, OnlineLeaderboard& leaderboard) const;
     uint64 GetLeaderboardHandle(const OnlineLeaderboard& leaderboard);
     bool GetLeaderboardEntries(uint64 call, Array<OnlineLeaderboardEntry, HeapAllocation>& entries) const;
+    bool InitializeGameServer(const SteamSettings* settings, uint32 appId);
     void OnUpdate();
+    void OnRelayNetworkStatus(const struct SteamRelayNetworkStatus_t& status);
 };
 
 #endif
@@ -0,0 +1,368 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamAvatarCache.h"
+#include "OnlinePlatformSteam.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Types/DataContainer.h"
+#include "Engine/Engine/Engine.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/Async/GPUTask.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Threading/Task.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+
+namespace
+{
+    // Sizes of the Steam avatars (in pixels) for each size bucket
+    constexpr int32 AvatarSizes[SteamAvatarCache::BucketsCount] = { 32, 64, 184 };
+
+    // Time (in seconds) after which the avatar that is missing or failed to load is requested again (or removed from cache if unused)
+    constexpr double FailedEntryTimeout = 30.0;
+
+    GPUTexture* CreateTexture(int32 width, int32 height)
+    {
+        if (!GPUDevice::Instance)
+            return nullptr;
+        GPUTexture* texture = GPUDevice::Instance->CreateTexture(TEXT("Steam.Avatar"));
+        if (texture->Init(GPUTextureDescription::New2D(width, height, PixelFormat::R8G8B8A8_UNorm)))
+        {
+            SAFE_DELETE_GPU_RESOURCE(texture);
+        }
+        return texture;
+    }
+
+    void UploadTexture(GPUTexture* texture, const Array<byte>& data)
+    {
+        BytesContainer container;
+        container.Link(data.Get(), data.Count());
+        GPUTask* task = texture->UploadMipMapAsync(container, 0, true);
+        if (task)
+            task->Start();
+    }
+}
+
+SteamAvatarCache::SteamAvatarCache(ISteamFriends* steamFriends, ISteamUtils* steamUtils, int64 memoryLimit, int32 atlasSize)
+    : _steamFriends(steamFriends)
+    , _steamUtils(steamUtils)
+    , _memoryLimit(memoryLimit)
+    , _atlasSize(atlasSize)
+{
+    for (int32 i = 0; i < BucketsCount; i++)
+    {
+        auto& bucket = _buckets[i];
+        bucket.SlotSize = AvatarSizes[i];
+        bucket.SlotsPerRow = _atlasSize > 0 ? _atlasSize / bucket.SlotSize : 0;
+    }
+}
+
+SteamAvatarCache::~SteamAvatarCache()
+{
+    // Wait for the decoding tasks to end
+    while (Platform::AtomicRead(&_pendingTasks) > 0)
+        Platform::Sleep(1);
+    Clear();
+}
+
+bool SteamAvatarCache::Get(uint64 steamId, SteamAvatarSize size, SteamAvatar& avatar)
+{
+    const int32 bucketIndex = (int32)size;
+    Bucket& bucket = _buckets[bucketIndex];
+    Entry* entry;
+    auto it = bucket.Entries.Find(steamId);
+    if (it.IsEnd())
+    {
+        entry = &bucket.Entries[steamId];
+        RequestImage(bucketIndex, steamId, *entry);
+    }
+    else
+    {
+        entry = &it->Value;
+        if (!entry->IsReady && !entry->IsLoading && Platform::GetTimeSeconds() - entry->FailTime >= FailedEntryTimeout)
+            RequestImage(bucketIndex, steamId, *entry);
+    }
+    entry->LastUsedFrame = Engine::FrameCount;
+    if (!entry->IsReady)
+        return true;
+
+    avatar.Width = entry->Width;
+    avatar.Height = entry->Height;
+    if (entry->AtlasSlot != -1)
+    {
+        const float atlasSize = (float)_atlasSize;
+        const int32 x = (entry->AtlasSlot % bucket.SlotsPerRow) * bucket.SlotSize;
+        const int32 y = (entry->AtlasSlot / bucket.SlotsPerRow) * bucket.SlotSize;
+        avatar.Texture = bucket.Atlas;
+        avatar.UVs = Rectangle((float)x / atlasSize, (float)y / atlasSize, (float)entry->Width / atlasSize, (float)entry->Height / atlasSize);
+    }
+    else
+    {
+        avatar.Texture = entry->Texture;
+        avatar.UVs = Rectangle(0.0f, 0.0f, 1.0f, 1.0f);
+    }
+    return false;
+}
+
+void SteamAvatarCache::Clear()
+{
+    for (auto& bucket : _buckets)
+    {
+        for (auto& e : bucket.Entries)
+            Free((int32)(&bucket - _buckets), e.Value);
+        bucket.Entries.Clear();
+        SAFE_DELETE_GPU_RESOURCE(bucket.Atlas);
+        bucket.AtlasData.Resize(0);
+        bucket.FreeSlots.Clear();
+        bucket.IsAtlasDirty = false;
+    }
+    _memoryUsage = 0;
+}
+
+void SteamAvatarCache::Update(Array<Pair<uint64, SteamAvatarSize>>& loaded)
+{
+    if (Platform::GetTimeSeconds() - _lastPruneTime >= FailedEntryTimeout)
+        PruneFailed();
+    _locker.Lock();
+    Array<DecodedImage> decoded = MoveTemp(_decoded);
+    _locker.Unlock();
+    if (decoded.IsEmpty())
+        return;
+    PROFILE_CPU();
+
+    for (const DecodedImage& image : decoded)
+    {
+        // Skip images that are no longer needed (eg. evicted or reloaded)
+        Bucket& bucket = _buckets[image.Bucket];
+        auto it = bucket.Entries.Find(image.SteamId);
+        if (it.IsEnd() || !it->Value.IsLoading || it->Value.Image != image.Image)
+            continue;
+        Entry& entry = it->Value;
+        entry.IsLoading = false;
+        if (entry.IsReady)
+            Free(image.Bucket, entry);
+        if (image.Pixels.IsEmpty())
+        {
+            LOG(Warning, "Failed to get Steam avatar image for user {0}", image.SteamId);
+            entry.FailTime = Platform::GetTimeSeconds();
+            continue;
+        }
+        if (Allocate(image.Bucket, image.SteamId, entry, image))
+        {
+            entry.FailTime = Platform::GetTimeSeconds();
+            continue;
+        }
+        loaded.Add(Pair<uint64, SteamAvatarSize>(image.SteamId, (SteamAvatarSize)image.Bucket));
+    }
+
+    // Upload modified atlases
+    for (auto& bucket : _buckets)
+    {
+        if (bucket.IsAtlasDirty)
+        {
+            bucket.IsAtlasDirty = false;
+            UploadTexture(bucket.Atlas, bucket.AtlasData);
+        }
+    }
+}
+
+void SteamAvatarCache::OnAvatarImageLoaded(uint64 steamId, int32 image, int32 width, int32 height)
+{
+    const int32 bucketIndex = width <= AvatarSizes[0] ? 0 : width <= AvatarSizes[1] ? 1 : 2;
+    auto it = _buckets[bucketIndex].Entries.Find(steamId);
+    if (it.IsNotEnd() && it->Value.IsLoading && it->Value.Image == -1)
+    {
+        it->Value.Image = image;
+        Decode(bucketIndex, steamId, image);
+    }
+}
+
+void SteamAvatarCache::OnAvatarChanged(uint64 steamId)
+{
+    for (int32 bucketIndex = 0; bucketIndex < BucketsCount; bucketIndex++)
+    {
+        auto it = _buckets[bucketIndex].Entries.Find(steamId);
+        if (it.IsNotEnd())
+            RequestImage(bucketIndex, steamId, it->Value);
+    }
+}
+
+void SteamAvatarCache::RequestImage(int32 bucket, uint64 steamId, Entry& entry)
+{
+    const CSteamID userId(steamId);
+    int32 image;
+    switch (bucket)
+    {
+    case 0:
+        image = _steamFriends->GetSmallFriendAvatar(userId);
+        break;
+    case 1:
+        image = _steamFriends->GetMediumFriendAvatar(userId);
+        break;
+    default:
+        image = _steamFriends->GetLargeFriendAvatar(userId);
+        break;
+    }
+    entry.Image = image;
+    if (image == -1)
+    {
+        // Wait for AvatarImageLoaded_t
+        entry.IsLoading = true;
+    }
+    else if (image == 0)
+    {
+        // User has no avatar or user info is not yet available (PersonaStateChange_t will trigger reload, otherwise retry after timeout)
+        entry.IsLoading = false;
+        entry.FailTime = Platform::GetTimeSeconds();
+        _steamFriends->RequestUserInformation(userId, false);
+    }
+    else
+    {
+        entry.IsLoading = true;
+        Decode(bucket, steamId, image);
+    }
+}
+
+void SteamAvatarCache::Decode(int32 bucket, uint64 steamId, int32 image)
+{
+    Platform::InterlockedIncrement(&_pendingTasks);
+    Function<void()> action = [this, bucket, steamId, image]
+    {
+        PROFILE_CPU_NAMED("Steam.DecodeAvatar");
+        DecodedImage decoded;
+        decoded.Bucket = bucket;
+        decoded.SteamId = steamId;
+        decoded.Image = image;
+        uint32 width, height;
+        if (_steamUtils->GetImageSize(image, &width, &height) && width != 0 && height != 0)
+        {
+            decoded.Width = (int32)width;
+            decoded.Height = (int32)height;
+            decoded.Pixels.Resize(decoded.Width * decoded.Height * 4);
+            if (!_steamUtils->GetImageRGBA(image, decoded.Pixels.Get(), decoded.Pixels.Count()))
+                decoded.Pixels.Clear();
+        }
+        _locker.Lock();
+        _decoded.Add(MoveTemp(decoded));
+        _locker.Unlock();
+        Platform::InterlockedDecrement(&_pendingTasks);
+    };
+    Task::StartNew(action);
+}
+
+bool SteamAvatarCache::Allocate(int32 bucketIndex, uint64 steamId, Entry& entry, const DecodedImage& image)
+{
+    Bucket& bucket = _buckets[bucketIndex];
+    entry.Width = image.Width;
+    entry.Height = image.Height;
+    if (bucket.SlotsPerRow != 0 && image.Width <= bucket.SlotSize && image.Height <= bucket.SlotSize)
+    {
+        // Pack into the atlas
+        if (!bucket.Atlas)
+        {
+            bucket.Atlas = CreateTexture(_atlasSize, _atlasSize);
+            if (bucket.Atlas)
+                _memoryUsage += (int64)_atlasSize * _atlasSize * 4;
+            bucket.AtlasData.Resize(_atlasSize * _atlasSize * 4);
+            Platform::MemoryClear(bucket.AtlasData.Get(), bucket.AtlasData.Count());
+            const int32 slotsCount = bucket.SlotsPerRow * bucket.SlotsPerRow;
+            bucket.FreeSlots.Resize(slotsCount);
+            for (int32 i = 0; i < slotsCount; i++)
+                bucket.FreeSlots[i] = slotsCount - i - 1;
+        }
+        if (bucket.FreeSlots.IsEmpty())
+            EvictLeastRecentlyUsed(bucketIndex);
+        if (bucket.Atlas && bucket.FreeSlots.HasItems())
+        {
+            entry.AtlasSlot = bucket.FreeSlots.Last();
+            bucket.FreeSlots.RemoveLast();
+            const int32 rowPitch = _atlasSize * 4;
+            const int32 x = (entry.AtlasSlot % bucket.SlotsPerRow) * bucket.SlotSize;
+            const int32 y = (entry.AtlasSlot / bucket.SlotsPerRow) * bucket.SlotSize;
+            byte* dst = bucket.AtlasData.Get() + y * rowPitch + x * 4;
+            const byte* src = image.Pixels.Get();
+            for (int32 row = 0; row < image.Height; row++)
+                Platform::MemoryCopy(dst + row * rowPitch, src + row * image.Width * 4, image.Width * 4);
+            bucket.IsAtlasDirty = true;
+            entry.IsReady = true;
+            return false;
+        }
+    }
+
+    // Make room in the cache (avatars used in the current frame are never evicted so the limit is soft)
+    const int64 size = image.Pixels.Count();
+    while (_memoryUsage + size > _memoryLimit && EvictLeastRecentlyUsed(-1))
+    {
+    }
+
+    // Use a separate texture
+    entry.Texture = CreateTexture(image.Width, image.Height);
+    if (!entry.Texture)
+        return true;
+    UploadTexture(entry.Texture, image.Pixels);
+    entry.IsReady = true;
+    _memoryUsage += size;
+    return false;
+}
+
+void SteamAvatarCache::Free(int32 bucket, Entry& entry)
+{
+    // Atlas memory is counted once for the whole atlas
+    if (entry.IsReady && entry.AtlasSlot == -1)
+        _memoryUsage -= entry.Width * entry.Height * 4;
+    SAFE_DELETE_GPU_RESOURCE(entry.Texture);
+    if (entry.AtlasSlot != -1)
+        _buckets[bucket].FreeSlots.Add(entry.AtlasSlot);
+    entry.AtlasSlot = -1;
+    entry.IsReady = false;
+}
+
+bool SteamAvatarCache::EvictLeastRecentlyUsed(int32 bucket)
+{
+    // Find the least recently used avatar (skip the ones used in the current frame), separate textures to free memory or atlas slots of the given bucket
+    int32 lruBucket = -1;
+    uint64 lruSteamId = 0;
+    uint64 lruFrame = Engine::FrameCount;
+    for (int32 bucketIndex = 0; bucketIndex < BucketsCount; bucketIndex++)
+    {
+        if (bucket != -1 && bucket != bucketIndex)
+            continue;
+        for (const auto& e : _buckets[bucketIndex].Entries)
+        {
+            if (e.Value.IsReady && e.Value.LastUsedFrame < lruFrame && (bucket == -1 ? e.Value.AtlasSlot == -1 : e.Value.AtlasSlot != -1))
+            {
+                lruBucket = bucketIndex;
+                lruSteamId = e.Key;
+                lruFrame = e.Value.LastUsedFrame;
+            }
+        }
+    }
+    if (lruBucket == -1)
+        return false;
+
+    auto& entries = _buckets[lruBucket].Entries;
+    auto it = entries.Find(lruSteamId);
+    Free(lruBucket, it->Value);
+    entries.Remove(it);
+    return true;
+}
+
+void SteamAvatarCache::PruneFailed()
+{
+    // Remove missing or failed avatars that were not used since the timeout (used ones are retried in Get)
+    _lastPruneTime = Platform::GetTimeSeconds();
+    for (auto& bucket : _buckets)
+    {
+        for (auto it = bucket.Entries.Begin(); it.IsNotEnd(); ++it)
+        {
+            const Entry& entry = it->Value;
+            if (!entry.IsReady && !entry.IsLoading && _lastPruneTime - entry.FailTime >= FailedEntryTimeout)
+                bucket.Entries.Remove(it);
+        }
+    }
+}
+
+#endif
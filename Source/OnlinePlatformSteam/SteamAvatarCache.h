@@ -0,0 +1,112 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/Pair.h"
+#include "Engine/Platform/CriticalSection.h"
+
+class ISteamFriends;
+class ISteamUtils;
+class GPUTexture;
+struct SteamAvatar;
+enum class SteamAvatarSize;
+
+/// <summary>
+/// Cache of the Steam users avatars. Images are fetched asynchronously (RGBA copy runs on a thread pool) and stored in a size-bucketed LRU cache with a memory limit. Optionally, avatars are packed into a shared texture atlas (one per size bucket, the whole atlas is counted into the memory usage once created). Users without avatar or with failed load are retried after a timeout. Used only on a main thread (except image decoding).
+/// </summary>
+class SteamAvatarCache
+{
+public:
+    static constexpr int32 BucketsCount = 3;
+
+private:
+    struct Entry
+    {
+        int32 Image = 0;
+        int32 Width = 0;
+        int32 Height = 0;
+        GPUTexture* Texture = nullptr;
+        int32 AtlasSlot = -1;
+        uint64 LastUsedFrame = 0;
+        double FailTime = 0.0;
+        bool IsLoading = false;
+        bool IsReady = false;
+    };
+
+    struct Bucket
+    {
+        int32 SlotSize;
+        int32 SlotsPerRow = 0;
+        Dictionary<uint64, Entry> Entries;
+        GPUTexture* Atlas = nullptr;
+        Array<byte> AtlasData;
+        Array<int32> FreeSlots;
+        bool IsAtlasDirty = false;
+    };
+
+    struct DecodedImage
+    {
+        int32 Bucket;
+        uint64 SteamId;
+        int32 Image;
+        int32 Width;
+        int32 Height;
+        Array<byte> Pixels;
+    };
+
+    ISteamFriends* _steamFriends;
+    ISteamUtils* _steamUtils;
+    Bucket _buckets[BucketsCount];
+    int64 _memoryLimit;
+    int64 _memoryUsage = 0;
+    int32 _atlasSize;
+    CriticalSection _locker;
+    Array<DecodedImage> _decoded;
+    volatile int64 _pendingTasks = 0;
+    double _lastPruneTime = 0.0;
+
+public:
+    SteamAvatarCache(ISteamFriends* steamFriends, ISteamUtils* steamUtils, int64 memoryLimit, int32 atlasSize);
+    ~SteamAvatarCache();
+
+public:
+    /// <summary>
+    /// Gets the user avatar. Starts loading it if not cached.
+    /// </summary>
+    /// <returns>True if avatar is not yet available, otherwise false.</returns>
+    bool Get(uint64 steamId, SteamAvatarSize size, SteamAvatar& avatar);
+
+    /// <summary>
+    /// Removes all cached avatars and releases their textures.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Processes the decoded images (uploads them to GPU). Returns the avatars that got ready (as SteamID and size pairs).
+    /// </summary>
+    void Update(Array<Pair<uint64, SteamAvatarSize>>& loaded);
+
+    /// <summary>
+    /// Handles the AvatarImageLoaded_t callback.
+    /// </summary>
+    void OnAvatarImageLoaded(uint64 steamId, int32 image, int32 width, int32 height);
+
+    /// <summary>
+    /// Handles the user avatar change (cached image gets reloaded on next use).
+    /// </summary>
+    void OnAvatarChanged(uint64 steamId);
+
+private:
+    void RequestImage(int32 bucket, uint64 steamId, Entry& entry);
+    void Decode(int32 bucket, uint64 steamId, int32 image);
+    bool Allocate(int32 bucket, uint64 steamId, Entry& entry, const DecodedImage& image);
+    void Free(int32 bucket, Entry& entry);
+    bool EvictLeastRecentlyUsed(int32 bucket);
+    void PruneFailed();
+};
+
+#endif
@@ -0,0 +1,136 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamFakeIP.h"
+#include "SteamHelpers.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+#include <Steamworks/steamnetworkingfakeip.h>
+
+static_assert(SteamFakeUDPPort::RecommendedMTU == k_cbSteamNetworkingSocketsFakeUDPPortRecommendedMTU, "Invalid FakeUDP MTU.");
+static_assert(SteamFakeUDPPort::MaxDatagramSize == k_cbSteamNetworkingSocketsFakeUDPPortMaxMessageSize, "Invalid FakeUDP max message size.");
+
+SteamFakeUDPPort::~SteamFakeUDPPort()
+{
+    Destroy();
+}
+
+bool SteamFakeUDPPort::RequestFakeIP(int32 portsCount)
+{
+    ISteamNetworkingSockets* sockets = GetNetworkingSockets();
+    if (!sockets || portsCount < 1 || portsCount > SteamNetworkingFakeIPResult_t::k_nMaxReturnPorts)
+        return true;
+    if (!sockets->BeginAsyncRequestFakeIP(portsCount))
+    {
+        LOG(Error, "Failed to request Steam FakeIP");
+        return true;
+    }
+    return false;
+}
+
+bool SteamFakeUDPPort::GetFakeIP(int32 portIndex, uint32& address, uint16& port)
+{
+    ISteamNetworkingSockets* sockets = GetNetworkingSockets();
+    if (!sockets || portIndex < 0 || portIndex >= SteamNetworkingFakeIPResult_t::k_nMaxReturnPorts)
+        return true;
+    SteamNetworkingFakeIPResult_t result;
+    sockets->GetFakeIP(0, &result);
+    if (result.m_eResult != k_EResultOK || result.m_unPorts[portIndex] == 0)
+        return true;
+    address = result.m_unIP;
+    port = result.m_unPorts[portIndex];
+    return false;
+}
+
+bool SteamFakeUDPPort::IsFakeIP(uint32 address)
+{
+    ISteamNetworkingUtils* utils = SteamNetworkingUtils();
+    return utils && utils->IsFakeIPv4(address);
+}
+
+bool SteamFakeUDPPort::Create(int32 portIndex)
+{
+    if (_port)
+        return true;
+    ISteamNetworkingSockets* sockets = GetNetworkingSockets();
+    if (!sockets)
+        return true;
+    _port = sockets->CreateFakeUDPPort(portIndex);
+    if (!_port)
+    {
+        LOG(Error, "Failed to create Steam FakeUDP port {0}", portIndex);
+        return true;
+    }
+    return false;
+}
+
+void SteamFakeUDPPort::Destroy()
+{
+    if (!_port)
+        return;
+    ReleaseReceived();
+    _port->DestroyFakeUDPPort();
+    _port = nullptr;
+}
+
+bool SteamFakeUDPPort::Send(uint32 address, uint16 port, const byte* data, int32 length)
+{
+    if (!_port || length > MaxDatagramSize)
+        return true;
+    SteamNetworkingIPAddr addr;
+    addr.SetIPv4(address, port);
+    return _port->SendMessageToFakeIP(addr, data, length, k_nSteamNetworkingSend_UnreliableNoNagle) != k_EResultOK;
+}
+
+int32 SteamFakeUDPPort::Receive(Array<Datagram>& datagrams)
+{
+    PROFILE_CPU();
+    ReleaseReceived();
+    datagrams.Clear();
+    if (!_port)
+        return 0;
+
+    // Receive in batches until the queue gets empty
+    while (true)
+    {
+        const int32 start = _received.Count();
+        _received.Resize(start + MaxReceivedMessages, false);
+        const int32 count = _port->ReceiveMessages(_received.Get() + start, MaxReceivedMessages);
+        _received.Resize(start + count, false);
+        if (count < MaxReceivedMessages)
+            break;
+    }
+
+    datagrams.Resize(_received.Count(), false);
+    for (int32 i = 0; i < _received.Count(); i++)
+    {
+        const SteamNetworkingMessage_t* message = _received[i];
+        const SteamNetworkingIPAddr* addr = message->m_identityPeer.GetIPAddr();
+        Datagram& datagram = datagrams[i];
+        datagram.Address = addr ? addr->GetIPv4() : 0;
+        datagram.Port = addr ? addr->m_port : 0;
+        datagram.Data = (const byte*)message->m_pData;
+        datagram.Length = message->m_cbSize;
+    }
+    return datagrams.Count();
+}
+
+void SteamFakeUDPPort::ScheduleCleanup(uint32 address, uint16 port)
+{
+    if (!_port)
+        return;
+    SteamNetworkingIPAddr addr;
+    addr.SetIPv4(address, port);
+    _port->ScheduleCleanup(addr);
+}
+
+void SteamFakeUDPPort::ReleaseReceived()
+{
+    for (SteamNetworkingMessage_t* message : _received)
+        message->Release();
+    _received.Clear();
+}
+
+#endif
@@ -0,0 +1,123 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Collections/Array.h"
+
+class ISteamNetworkingFakeUDPPort;
+struct SteamNetworkingMessage_t;
+
+/// <summary>
+/// UDP-like socket that sends and receives datagrams addressed with Steam FakeIP addresses (IPv4 and port). Traffic goes through Steam Datagram Relay so it doesn't need its own NAT traversal. Intended for porting the existing code that uses plain IPv4 sockets (eg. third-party voice libraries). Requires Steam online platform to be initialized.
+/// </summary>
+/// <remarks>Send and ScheduleCleanup can be called from any thread. Receive has to be called from a single thread.</remarks>
+class ONLINEPLATFORMSTEAM_API SteamFakeUDPPort
+{
+public:
+    /// <summary>
+    /// The recommended maximum datagram size (in bytes) that doesn't get fragmented.
+    /// </summary>
+    static constexpr int32 RecommendedMTU = 1200;
+
+    /// <summary>
+    /// The maximum datagram size (in bytes).
+    /// </summary>
+    static constexpr int32 MaxDatagramSize = 4096;
+
+    /// <summary>
+    /// The received datagram. Data is owned by the port and stays valid until the next Receive call.
+    /// </summary>
+    struct Datagram
+    {
+        uint32 Address;
+        uint16 Port;
+        const byte* Data;
+        int32 Length;
+    };
+
+private:
+    // Maximum amount of datagrams received from Steam at once
+    static constexpr int32 MaxReceivedMessages = 256;
+
+    ISteamNetworkingFakeUDPPort* _port = nullptr;
+    Array<SteamNetworkingMessage_t*> _received;
+
+public:
+    ~SteamFakeUDPPort();
+
+public:
+    /// <summary>
+    /// Starts the asynchronous request of the global FakeIP address for the local user. Has to be called once, before creating the server ports (ideally on startup).
+    /// </summary>
+    /// <param name="portsCount">The amount of ports to allocate (server ports, up to 8).</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    static bool RequestFakeIP(int32 portsCount = 1);
+
+    /// <summary>
+    /// Gets the global FakeIP address assigned to the local user (see RequestFakeIP).
+    /// </summary>
+    /// <param name="portIndex">The index of the allocated port.</param>
+    /// <param name="address">The output IPv4 address (host byte order).</param>
+    /// <param name="port">The output port.</param>
+    /// <returns>True if address is not yet assigned, the request failed or the port was not allocated, otherwise false.</returns>
+    static bool GetFakeIP(int32 portIndex, uint32& address, uint16& port);
+
+    /// <summary>
+    /// Checks if the given IPv4 address is a Steam FakeIP.
+    /// </summary>
+    /// <param name="address">The IPv4 address (host byte order).</param>
+    /// <returns>True if it's a FakeIP address, otherwise false.</returns>
+    static bool IsFakeIP(uint32 address);
+
+public:
+    /// <summary>
+    /// Creates the port.
+    /// </summary>
+    /// <param name="portIndex">The index of the allocated port (see RequestFakeIP) to receive datagrams sent to the global FakeIP address, or -1 to create a client port with an ephemeral local address.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Create(int32 portIndex = -1);
+
+    /// <summary>
+    /// Destroys the port and releases the received datagrams.
+    /// </summary>
+    void Destroy();
+
+    /// <summary>
+    /// Checks if port has been created.
+    /// </summary>
+    bool IsCreated() const
+    {
+        return _port != nullptr;
+    }
+
+    /// <summary>
+    /// Sends the unreliable datagram to the given FakeIP address. Datagram is sent immediately (without Nagle delay).
+    /// </summary>
+    /// <param name="address">The target IPv4 address (host byte order).</param>
+    /// <param name="port">The target port.</param>
+    /// <param name="data">The datagram data.</param>
+    /// <param name="length">The datagram size (in bytes, up to MaxDatagramSize).</param>
+    /// <returns>True if failed (eg. FakeIP allocation is not yet completed or address is unknown), otherwise false.</returns>
+    bool Send(uint32 address, uint16 port, const byte* data, int32 length);
+
+    /// <summary>
+    /// Receives all pending datagrams (in batches). Releases datagrams received by the previous call.
+    /// </summary>
+    /// <param name="datagrams">The output received datagrams.</param>
+    /// <returns>The amount of received datagrams.</returns>
+    int32 Receive(Array<Datagram>& datagrams);
+
+    /// <summary>
+    /// Schedules the internal connection to the given peer to be cleaned up soon (eg. after sending or receiving application-level disconnect). Idle connections time out automatically.
+    /// </summary>
+    /// <param name="address">The peer IPv4 address (host byte order).</param>
+    /// <param name="port">The peer port.</param>
+    void ScheduleCleanup(uint32 address, uint16 port);
+
+private:
+    void ReleaseReceived();
+};
+
+#endif
@@ -0,0 +1,23 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Types/DateTime.h"
+#include "Engine/Core/Types/Guid.h"
+#include "Engine/Online/IOnlinePlatform.h"
+#include <Steamworks/steam_api.h>
+
+// Conversion utilities shared by the Steam platform implementation (defined in OnlinePlatformSteam.cpp)
+
+DateTime DateTimeFromUnixTimestamp(int32 unixTime);
+Guid GetUserId(CSteamID id);
+CSteamID GetSteamId(const Guid& id);
+OnlinePresenceStates GetUserPresence(EPersonaState state);
+
+// Gets the networking interfaces of the game server (in game server mode) or the client
+ISteamNetworkingSockets* GetNetworkingSockets();
+ISteamNetworkingMessages* GetNetworkingMessages();
+
+#endif
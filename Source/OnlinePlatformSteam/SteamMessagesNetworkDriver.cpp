@@ -0,0 +1,360 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamMessagesNetworkDriver.h"
+#include "SteamHelpers.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Networking/NetworkPeer.h"
+#include "Engine/Networking/NetworkMessage.h"
+#include "Engine/Networking/NetworkChannelType.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+
+namespace
+{
+    // Active drivers (used to dispatch session callbacks)
+    Array<SteamMessagesNetworkDriver*> Drivers;
+
+    // Steam channel used for driver control messages (channels below are used by NetworkChannelType)
+    constexpr int32 ControlChannel = (int32)NetworkChannelType::ReliableOrdered + 1;
+
+    // Control message sent by the peer that disconnects (sessions have no 'closed by peer' notification)
+    constexpr byte DisconnectMessage = 1;
+
+    // Control message sent by the client to open the session (server learns about the client from the session request)
+    constexpr byte ConnectMessage = 2;
+
+    int32 GetSendFlags(NetworkChannelType channelType)
+    {
+        switch (channelType)
+        {
+        case NetworkChannelType::Reliable:
+        case NetworkChannelType::ReliableOrdered:
+            return k_nSteamNetworkingSend_Reliable;
+        default:
+            return k_nSteamNetworkingSend_Unreliable;
+        }
+    }
+
+    SteamNetworkingIdentity GetIdentity(uint64 steamId)
+    {
+        SteamNetworkingIdentity identity;
+        identity.SetSteamID64(steamId);
+        return identity;
+    }
+}
+
+SteamMessagesNetworkDriver::SteamMessagesNetworkDriver(const SpawnParams& params)
+    : ScriptingObject(params)
+{
+}
+
+bool SteamMessagesNetworkDriver::Initialize(NetworkPeer* host, const NetworkConfig& config)
+{
+    _networkHost = host;
+    _config = config;
+    _messages = GetNetworkingMessages();
+    if (!_messages)
+    {
+        LOG(Error, "Steam Networking Messages are unavailable. Ensure to initialize Steam online platform first.");
+        return true;
+    }
+    if (Drivers.IsEmpty())
+    {
+        SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionRequest(&OnSessionRequest);
+        SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionFailed(&OnSessionFailed);
+    }
+    Drivers.Add(this);
+    LOG(Info, "Initialized Steam messages network driver");
+    return false;
+}
+
+void SteamMessagesNetworkDriver::Dispose()
+{
+    if (!_messages)
+        return;
+    for (int32 i = _receivedIndex; i < _receivedCount; i++)
+        _received[i]->Release();
+    _receivedCount = _receivedIndex = 0;
+    const byte disconnect = DisconnectMessage;
+    for (const auto& e : _steamIds)
+    {
+        const SteamNetworkingIdentity identity = GetIdentity(e.Value);
+        _messages->SendMessageToUser(identity, &disconnect, sizeof(disconnect), k_nSteamNetworkingSend_Reliable, ControlChannel);
+        _messages->CloseSessionWithUser(identity);
+    }
+    _connectionIds.Clear();
+    _steamIds.Clear();
+    _events.Clear();
+    _eventIndex = 0;
+    _isServer = false;
+    _serverConnection = 0;
+    _messages = nullptr;
+    Drivers.Remove(this);
+    if (Drivers.IsEmpty())
+    {
+        SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionRequest(nullptr);
+        SteamNetworkingUtils()->SetGlobalCallback_MessagesSessionFailed(nullptr);
+    }
+    LOG(Info, "Steam messages network driver disposed");
+}
+
+bool SteamMessagesNetworkDriver::Listen()
+{
+    // Sessions are accepted on request
+    _isServer = true;
+    LOG(Info, "Listening for Steam messages sessions");
+    return false;
+}
+
+bool SteamMessagesNetworkDriver::Connect()
+{
+    uint64 steamId;
+    if (StringUtils::Parse(_config.Address.Get(), _config.Address.Length(), &steamId))
+    {
+        LOG(Error, "Invalid server address '{0}'. Steam messages network driver requires server SteamID.", _config.Address);
+        return true;
+    }
+
+    // Session gets established with the first message sent (failure is reported via session failed callback)
+    const byte connect = ConnectMessage;
+    const EResult result = _messages->SendMessageToUser(GetIdentity(steamId), &connect, sizeof(connect), k_nSteamNetworkingSend_Reliable | k_nSteamNetworkingSend_AutoRestartBrokenSession, ControlChannel);
+    if (result != k_EResultOK)
+    {
+        LOG(Error, "Failed to connect to Steam user {0} (result: {1})", steamId, (int32)result);
+        return true;
+    }
+    _serverConnection = AddPeer(steamId);
+    auto& e = _events.AddOne();
+    e.EventType = NetworkEventType::Connected;
+    e.Sender.ConnectionId = _serverConnection;
+    LOG(Info, "Connecting to Steam user {0}", steamId);
+    return false;
+}
+
+void SteamMessagesNetworkDriver::Disconnect()
+{
+    if (_serverConnection)
+    {
+        NetworkConnection connection;
+        connection.ConnectionId = _serverConnection;
+        Disconnect(connection);
+        _serverConnection = 0;
+        LOG(Info, "Disconnected");
+    }
+}
+
+void SteamMessagesNetworkDriver::Disconnect(const NetworkConnection& connection)
+{
+    uint64 steamId;
+    if (_steamIds.TryGet(connection.ConnectionId, steamId))
+    {
+        const SteamNetworkingIdentity identity = GetIdentity(steamId);
+        const byte disconnect = DisconnectMessage;
+        _messages->SendMessageToUser(identity, &disconnect, sizeof(disconnect), k_nSteamNetworkingSend_Reliable, ControlChannel);
+        _messages->CloseSessionWithUser(identity);
+        _steamIds.Remove(connection.ConnectionId);
+        _connectionIds.Remove(steamId);
+    }
+}
+
+bool SteamMessagesNetworkDriver::PopEvent(NetworkEvent& eventPtr)
+{
+    if (_eventIndex == _events.Count() && _receivedIndex == _receivedCount)
+    {
+        // Dispatch session callbacks and receive messages
+        _events.Clear();
+        _eventIndex = 0;
+        GetNetworkingSockets()->RunCallbacks();
+        Receive();
+    }
+
+    // Session changes
+    if (_eventIndex < _events.Count())
+    {
+        eventPtr = _events[_eventIndex++];
+        return true;
+    }
+
+    // Messages
+    while (_receivedIndex < _receivedCount)
+    {
+        SteamNetworkingMessage_t* steamMessage = _received[_receivedIndex++];
+        uint32 connection;
+        if (!_connectionIds.TryGet(steamMessage->m_identityPeer.GetSteamID64(), connection))
+        {
+            steamMessage->Release();
+            continue;
+        }
+        if (steamMessage->m_nChannel == ControlChannel)
+        {
+            // Control message
+            const bool disconnect = steamMessage->m_cbSize == 1 && *(const byte*)steamMessage->m_pData == DisconnectMessage;
+            steamMessage->Release();
+            if (disconnect)
+            {
+                RemovePeer(connection, NetworkEventType::Disconnected);
+                eventPtr = _events[_eventIndex++];
+                return true;
+            }
+            continue;
+        }
+        NetworkMessage message = _networkHost->CreateMessage();
+        if ((uint32)steamMessage->m_cbSize > message.BufferSize)
+        {
+            LOG(Warning, "Received too big message ({0} bytes) from connection with id = {1}", steamMessage->m_cbSize, connection);
+            _networkHost->RecycleMessage(message);
+            steamMessage->Release();
+            continue;
+        }
+        Platform::MemoryCopy(message.Buffer, steamMessage->m_pData, steamMessage->m_cbSize);
+        message.Length = steamMessage->m_cbSize;
+        eventPtr.EventType = NetworkEventType::Message;
+        eventPtr.Message = message;
+        eventPtr.Sender.ConnectionId = connection;
+        _totalDataReceived += steamMessage->m_cbSize;
+        steamMessage->Release();
+        return true;
+    }
+
+    return false;
+}
+
+void SteamMessagesNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message)
+{
+    Send(_serverConnection, channelType, message);
+}
+
+void SteamMessagesNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message, NetworkConnection target)
+{
+    Send(target.ConnectionId, channelType, message);
+}
+
+void SteamMessagesNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message, const Array<NetworkConnection, HeapAllocation>& targets)
+{
+    for (const NetworkConnection& target : targets)
+        Send(target.ConnectionId, channelType, message);
+}
+
+NetworkDriverStats SteamMessagesNetworkDriver::GetStats()
+{
+    NetworkConnection target;
+    target.ConnectionId = _serverConnection;
+    return GetStats(target);
+}
+
+NetworkDriverStats SteamMessagesNetworkDriver::GetStats(NetworkConnection target)
+{
+    NetworkDriverStats stats;
+    uint64 steamId;
+    SteamNetConnectionRealTimeStatus_t status;
+    if (_messages && _steamIds.TryGet(target.ConnectionId, steamId) && _messages->GetSessionConnectionInfo(GetIdentity(steamId), nullptr, &status) == k_ESteamNetworkingConnectionState_Connected)
+        stats.RTT = (float)status.m_nPing;
+    stats.TotalDataSent = _totalDataSent;
+    stats.TotalDataReceived = _totalDataReceived;
+    return stats;
+}
+
+uint32 SteamMessagesNetworkDriver::AddPeer(uint64 steamId)
+{
+    uint32 connection;
+    if (!_connectionIds.TryGet(steamId, connection))
+    {
+        connection = _nextConnectionId++;
+        _connectionIds.Add(steamId, connection);
+        _steamIds.Add(connection, steamId);
+    }
+    return connection;
+}
+
+void SteamMessagesNetworkDriver::RemovePeer(uint32 connection, NetworkEventType eventType)
+{
+    uint64 steamId;
+    if (!_steamIds.TryGet(connection, steamId))
+        return;
+    _messages->CloseSessionWithUser(GetIdentity(steamId));
+    _steamIds.Remove(connection);
+    _connectionIds.Remove(steamId);
+    if (connection == _serverConnection)
+        _serverConnection = 0;
+    auto& e = _events.AddOne();
+    e.EventType = eventType;
+    e.Sender.ConnectionId = connection;
+}
+
+void SteamMessagesNetworkDriver::Send(uint32 connection, NetworkChannelType channelType, const NetworkMessage& message)
+{
+    uint64 steamId;
+    if (!_steamIds.TryGet(connection, steamId))
+        return;
+    const int32 flags = GetSendFlags(channelType) | k_nSteamNetworkingSend_AutoRestartBrokenSession;
+    const EResult result = _messages->SendMessageToUser(GetIdentity(steamId), message.Buffer, message.Length, flags, (int32)channelType);
+    if (result != k_EResultOK)
+    {
+        LOG(Warning, "Failed to send message to connection with id = {0} (result: {1})", connection, (int32)result);
+        return;
+    }
+    _totalDataSent += message.Length;
+}
+
+void SteamMessagesNetworkDriver::Receive()
+{
+    PROFILE_CPU();
+    static_assert(ControlChannel + 1 == ChannelsCount, "Invalid Steam channels count.");
+    _receivedIndex = 0;
+    _receivedCount = 0;
+    for (int32 channel = 0; channel < ChannelsCount; channel++)
+    {
+        const int32 count = _messages->ReceiveMessagesOnChannel(channel, _received + _receivedCount, MaxReceivedMessages);
+        if (count > 0)
+            _receivedCount += count;
+    }
+}
+
+void SteamMessagesNetworkDriver::OnSessionRequest(SteamNetworkingMessagesSessionRequest_t* data)
+{
+    const uint64 steamId = data->m_identityRemote.GetSteamID64();
+    for (SteamMessagesNetworkDriver* driver : Drivers)
+    {
+        if (driver->_isServer)
+        {
+            if (driver->_steamIds.Count() >= driver->_config.ConnectionsLimit)
+            {
+                LOG(Warning, "Rejected Steam messages session from user {0} (server full)", steamId);
+                driver->_messages->CloseSessionWithUser(data->m_identityRemote);
+                return;
+            }
+            if (driver->_messages->AcceptSessionWithUser(data->m_identityRemote))
+            {
+                auto& e = driver->_events.AddOne();
+                e.EventType = NetworkEventType::Connected;
+                e.Sender.ConnectionId = driver->AddPeer(steamId);
+            }
+            return;
+        }
+        if (driver->_connectionIds.ContainsKey(steamId))
+        {
+            // Server replied to the client
+            driver->_messages->AcceptSessionWithUser(data->m_identityRemote);
+            return;
+        }
+    }
+}
+
+void SteamMessagesNetworkDriver::OnSessionFailed(SteamNetworkingMessagesSessionFailed_t* data)
+{
+    const uint64 steamId = data->m_info.m_identityRemote.GetSteamID64();
+    LOG(Warning, "Steam messages session with user {0} failed: {1}", steamId, String(data->m_info.m_szEndDebug));
+    for (SteamMessagesNetworkDriver* driver : Drivers)
+    {
+        uint32 connection;
+        if (driver->_connectionIds.TryGet(steamId, connection))
+        {
+            driver->RemovePeer(connection, NetworkEventType::Timeout);
+            return;
+        }
+    }
+}
+
+#endif
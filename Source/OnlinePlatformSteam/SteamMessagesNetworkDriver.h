@@ -0,0 +1,79 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Networking/Types.h"
+#include "Engine/Networking/INetworkDriver.h"
+#include "Engine/Networking/NetworkConnection.h"
+#include "Engine/Networking/NetworkConfig.h"
+#include "Engine/Networking/NetworkEvent.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Scripting/ScriptingObject.h"
+
+class ISteamNetworkingMessages;
+struct SteamNetworkingMessage_t;
+struct SteamNetworkingMessagesSessionRequest_t;
+struct SteamNetworkingMessagesSessionFailed_t;
+
+/// <summary>
+/// Connectionless network driver implementation for Steam Networking Messages. Peers are addressed by SteamID and Steam manages the sessions, so there is no per-peer connection state on the driver side except for mapping SteamIDs into connection identifiers. Flax network channels are mapped into Steam channel numbers. Suited for small lobbies and side channels. Requires Steam online platform to be initialized.
+/// </summary>
+/// <remarks>Client sends messages to the server SteamID given in NetworkConfig.Address.</remarks>
+API_CLASS(Sealed, Namespace="FlaxEngine.Online.Steam") class ONLINEPLATFORMSTEAM_API SteamMessagesNetworkDriver : public ScriptingObject, public INetworkDriver
+{
+    DECLARE_SCRIPTING_TYPE(SteamMessagesNetworkDriver);
+private:
+    // Amount of Steam channels used (NetworkChannelType values and the driver control channel)
+    static constexpr int32 ChannelsCount = 6;
+
+    // Maximum amount of messages received from Steam at once (per channel, so busy channels don't starve others)
+    static constexpr int32 MaxReceivedMessages = 64;
+
+    NetworkConfig _config;
+    NetworkPeer* _networkHost = nullptr;
+    ISteamNetworkingMessages* _messages = nullptr;
+    bool _isServer = false;
+    uint32 _serverConnection = 0;
+    uint32 _nextConnectionId = 1;
+    Dictionary<uint64, uint32> _connectionIds;
+    Dictionary<uint32, uint64> _steamIds;
+    Array<NetworkEvent> _events;
+    int32 _eventIndex = 0;
+    SteamNetworkingMessage_t* _received[MaxReceivedMessages * ChannelsCount];
+    int32 _receivedCount = 0;
+    int32 _receivedIndex = 0;
+    uint32 _totalDataSent = 0;
+    uint32 _totalDataReceived = 0;
+
+public:
+    // [INetworkDriver]
+    String DriverName() const override
+    {
+        return String("SteamMessagesNetworkDriver");
+    }
+    bool Initialize(NetworkPeer* host, const NetworkConfig& config) override;
+    void Dispose() override;
+    bool Listen() override;
+    bool Connect() override;
+    void Disconnect() override;
+    void Disconnect(const NetworkConnection& connection) override;
+    bool PopEvent(NetworkEvent& eventPtr) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, NetworkConnection target) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, const Array<NetworkConnection, HeapAllocation>& targets) override;
+    NetworkDriverStats GetStats() override;
+    NetworkDriverStats GetStats(NetworkConnection target) override;
+
+private:
+    uint32 AddPeer(uint64 steamId);
+    void RemovePeer(uint32 connection, NetworkEventType eventType);
+    void Send(uint32 connection, NetworkChannelType channelType, const NetworkMessage& message);
+    void Receive();
+    static void OnSessionRequest(SteamNetworkingMessagesSessionRequest_t* data);
+    static void OnSessionFailed(SteamNetworkingMessagesSessionFailed_t* data);
+};
+
+#endif
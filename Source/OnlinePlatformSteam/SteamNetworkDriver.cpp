@@ -0,0 +1,1433 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamNetworkDriver.h"
+#include "SteamNetworkSignaling.h"
+#include "SteamHelpers.h"
+#include "OnlinePlatformSteam.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Engine/Engine.h"
+#include "Engine/Networking/NetworkPeer.h"
+#include "Engine/Networking/NetworkMessage.h"
+#include "Engine/Networking/NetworkChannelType.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Platform/Thread.h"
+#include "Engine/Threading/IRunnable.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+#include <ThirdParty/LZ4/lz4.h>
+
+// Custom signaling interfaces (steamnetworkingcustomsignaling.h is not included in the Steamworks SDK headers shipped with the plugin)
+class ISteamNetworkingConnectionSignaling
+{
+public:
+    virtual bool SendSignal(HSteamNetConnection hConn, const SteamNetConnectionInfo_t& info, const void* pMsg, int cbMsg) = 0;
+    virtual void Release() = 0;
+};
+
+class ISteamNetworkingSignalingRecvContext
+{
+public:
+    virtual ISteamNetworkingConnectionSignaling* OnConnectRequest(HSteamNetConnection hConn, const SteamNetworkingIdentity& identityPeer, int nLocalVirtualPort) = 0;
+    virtual void SendRejectionSignal(const SteamNetworkingIdentity& identityPeer, const void* pMsg, int cbMsg) = 0;
+};
+
+namespace
+{
+    // Custom signaling backend (null if unused)
+    CriticalSection SignalingLocker;
+    SteamNetworkSignaling* Signaling = nullptr;
+
+    // Gets the custom signaling backend with the reference added (null if unused)
+    SteamNetworkSignaling* AcquireSignaling()
+    {
+        ScopeLock lock(SignalingLocker);
+        if (Signaling)
+            Signaling->AddRef();
+        return Signaling;
+    }
+
+    // Routes signals of a single connection to the custom signaling backend (owned by Steam, called from any thread)
+    class SteamSignalingConnection : public ISteamNetworkingConnectionSignaling
+    {
+    private:
+        SteamNetworkSignaling* _signaling;
+        uint64 _steamId;
+
+    public:
+        SteamSignalingConnection(SteamNetworkSignaling* signaling, uint64 steamId)
+            : _signaling(signaling)
+            , _steamId(steamId)
+        {
+            // Keep the backend alive for the connection lifetime
+            _signaling->AddRef();
+        }
+
+        ~SteamSignalingConnection()
+        {
+            _signaling->Release();
+        }
+
+        bool SendSignal(HSteamNetConnection hConn, const SteamNetConnectionInfo_t& info, const void* pMsg, int cbMsg) override
+        {
+            return !_signaling->SendSignal(_steamId, (const byte*)pMsg, cbMsg);
+        }
+
+        void Release() override
+        {
+            Delete(this);
+        }
+    };
+
+    // Active drivers (used to dispatch connection status callbacks)
+    CriticalSection DriversLocker;
+    Array<SteamNetworkDriver*> Drivers;
+
+    // Shared payload of the outgoing messages (data follows the header). Steam releases sent messages from any thread.
+    struct SendPayload
+    {
+        int64 RefCount;
+        int64 Capacity;
+    };
+
+    // Pool of the payloads reused for sending (sized to fit a typical network message)
+    constexpr int32 PooledPayloadCapacity = 2048;
+    constexpr int32 MaxPooledPayloads = 1024;
+    CriticalSection PayloadPoolLocker;
+    Array<SendPayload*> PayloadPool;
+
+    SendPayload* AllocatePayload(int32 size)
+    {
+        SendPayload* payload = nullptr;
+        if (size <= PooledPayloadCapacity)
+        {
+            PayloadPoolLocker.Lock();
+            if (PayloadPool.HasItems())
+            {
+                payload = PayloadPool.Last();
+                PayloadPool.RemoveLast();
+            }
+            PayloadPoolLocker.Unlock();
+            size = PooledPayloadCapacity;
+        }
+        if (!payload)
+        {
+            payload = (SendPayload*)Platform::Allocate(sizeof(SendPayload) + size, 16);
+            payload->Capacity = size;
+        }
+        payload->RefCount = 0;
+        return payload;
+    }
+
+    void FreePayload(SendPayload* payload)
+    {
+        if (payload->Capacity == PooledPayloadCapacity)
+        {
+            ScopeLock lock(PayloadPoolLocker);
+            if (PayloadPool.Count() < MaxPooledPayloads)
+            {
+                PayloadPool.Add(payload);
+                return;
+            }
+        }
+        Platform::Free(payload);
+    }
+
+    void ClearPayloadPool()
+    {
+        ScopeLock lock(PayloadPoolLocker);
+        for (SendPayload* payload : PayloadPool)
+            Platform::Free(payload);
+        PayloadPool.Resize(0);
+    }
+
+    void OnFreeMessageData(SteamNetworkingMessage_t* message)
+    {
+        auto payload = (SendPayload*)message->m_nUserData;
+        if (Platform::InterlockedDecrement(&payload->RefCount) == 0)
+            FreePayload(payload);
+    }
+
+    bool SetImpairmentConfig(ESteamNetworkingConfigScope scope, intptr_t scopeObj, const SteamNetworkImpairment& impairment)
+    {
+        ISteamNetworkingUtils* utils = SteamNetworkingUtils();
+        if (!utils)
+            return true;
+        const int32 lagSend = Math::Max(impairment.PacketLagSend, 0);
+        const int32 lagRecv = Math::Max(impairment.PacketLagRecv, 0);
+        const int32 reorderTime = Math::Max(impairment.PacketReorderTime, 0);
+        const float lossSend = Math::Clamp(impairment.PacketLossSend, 0.0f, 100.0f);
+        const float lossRecv = Math::Clamp(impairment.PacketLossRecv, 0.0f, 100.0f);
+        const float reorderSend = Math::Clamp(impairment.PacketReorderSend, 0.0f, 100.0f);
+        const float reorderRecv = Math::Clamp(impairment.PacketReorderRecv, 0.0f, 100.0f);
+        bool result = true;
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketLoss_Send, scope, scopeObj, k_ESteamNetworkingConfig_Float, &lossSend);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketLoss_Recv, scope, scopeObj, k_ESteamNetworkingConfig_Float, &lossRecv);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketLag_Send, scope, scopeObj, k_ESteamNetworkingConfig_Int32, &lagSend);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketLag_Recv, scope, scopeObj, k_ESteamNetworkingConfig_Int32, &lagRecv);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketReorder_Send, scope, scopeObj, k_ESteamNetworkingConfig_Float, &reorderSend);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketReorder_Recv, scope, scopeObj, k_ESteamNetworkingConfig_Float, &reorderRecv);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_FakePacketReorder_Time, scope, scopeObj, k_ESteamNetworkingConfig_Int32, &reorderTime);
+        return !result;
+    }
+
+    // Compression dictionary shared by all drivers (protected by DriversLocker)
+    constexpr int32 MaxCompressionDictionarySize = 64 * 1024;
+    Array<byte> CompressionDictionary;
+
+    // Payload header size of the messages sent on the lanes with compression enabled (format and optional dictionary identifier)
+    constexpr int32 MaxPayloadHeaderSize = 1 + sizeof(uint32);
+
+    // Identifies the dictionary so peers with a different dictionary reject the messages instead of decoding garbage (FNV-1a hash)
+    uint32 GetDictionaryId(const Array<byte>& dictionary)
+    {
+        uint32 hash = 2166136261u;
+        for (const byte e : dictionary)
+            hash = (hash ^ e) * 16777619u;
+        return hash;
+    }
+
+    // Header of the messages sent on the lanes with compression enabled
+    enum class PayloadFormat : byte
+    {
+        Raw = 0,
+        LZ4 = 1,
+        LZ4Dictionary = 2,
+    };
+
+    // Send rate bounds of the adaptive controller used when not specified in the policy
+    constexpr int32 AdaptiveSendRateMin = 64 * 1024;
+    constexpr int32 AdaptiveSendRateMax = 1024 * 1024;
+
+    // Interval (in seconds) of the adaptive send rate controller updates (independent from the network stats sampling)
+    constexpr double AdaptiveSendRateInterval = 0.1;
+
+    bool SetSendRateConfig(ISteamNetworkingUtils* utils, uint32 connection, int32 sendRateMin, int32 sendRateMax, float nagleTime)
+    {
+        // Non-positive rate removes the connection value so it inherits the global one (eg. when switching from adaptive policy)
+        const intptr_t scopeObj = (intptr_t)connection;
+        const int32 nagleTimeUsec = (int32)(Math::Clamp(nagleTime, 0.0f, 1000.0f) * 1000.0f);
+        bool result = utils->SetConfigValue(k_ESteamNetworkingConfig_NagleTime, k_ESteamNetworkingConfig_Connection, scopeObj, k_ESteamNetworkingConfig_Int32, &nagleTimeUsec);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_SendRateMin, k_ESteamNetworkingConfig_Connection, scopeObj, k_ESteamNetworkingConfig_Int32, sendRateMin > 0 ? &sendRateMin : nullptr);
+        result &= utils->SetConfigValue(k_ESteamNetworkingConfig_SendRateMax, k_ESteamNetworkingConfig_Connection, scopeObj, k_ESteamNetworkingConfig_Int32, sendRateMax > 0 ? &sendRateMax : nullptr);
+        return !result;
+    }
+
+    int32 GetLane(NetworkChannelType channelType)
+    {
+        return Math::Clamp((int32)channelType - (int32)NetworkChannelType::Unreliable, 0, 3);
+    }
+
+    int32 GetSendFlags(NetworkChannelType channelType)
+    {
+        switch (channelType)
+        {
+        case NetworkChannelType::Reliable:
+        case NetworkChannelType::ReliableOrdered:
+            return k_nSteamNetworkingSend_Reliable;
+        default:
+            return k_nSteamNetworkingSend_Unreliable;
+        }
+    }
+}
+
+/// <summary>
+/// Handles the incoming connection requests received via custom signaling.
+/// </summary>
+class SteamSignalingRecvContext : public ISteamNetworkingSignalingRecvContext
+{
+private:
+    SteamNetworkDriver* _driver;
+    SteamNetworkSignaling* _signaling;
+
+public:
+    SteamSignalingRecvContext(SteamNetworkDriver* driver, SteamNetworkSignaling* signaling)
+        : _driver(driver)
+        , _signaling(signaling)
+    {
+    }
+
+    ISteamNetworkingConnectionSignaling* OnConnectRequest(HSteamNetConnection hConn, const SteamNetworkingIdentity& identityPeer, int nLocalVirtualPort) override
+    {
+        if (!_driver->IsServer() || nLocalVirtualPort != (int32)_driver->_config.Port)
+            return nullptr;
+        auto callback = &SteamNetworkDriver::OnConnectionStatusChanged;
+        _driver->_utils->SetConfigValue(k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged, k_ESteamNetworkingConfig_Connection, hConn, k_ESteamNetworkingConfig_Ptr, &callback);
+        ScopeLock lock(_driver->_locker);
+        _driver->_signaledConnections.Add(hConn);
+        return New<SteamSignalingConnection>(_signaling, identityPeer.GetSteamID64());
+    }
+
+    void SendRejectionSignal(const SteamNetworkingIdentity& identityPeer, const void* pMsg, int cbMsg) override
+    {
+        _signaling->SendSignal(identityPeer.GetSteamID64(), (const byte*)pMsg, cbMsg);
+    }
+};
+
+/// <summary>
+/// Dedicated network thread of the Steam network driver. Runs networking callbacks, drains the poll group into the driver inbox and submits the outbox when requested by the game thread.
+/// </summary>
+class SteamNetworkDriverThread : public IRunnable
+{
+private:
+    SteamNetworkDriver* _driver;
+    Thread* _thread = nullptr;
+    volatile int64 _exitRequested = 0;
+
+public:
+    SteamNetworkDriverThread(SteamNetworkDriver* driver)
+        : _driver(driver)
+    {
+    }
+
+    bool Start()
+    {
+        _thread = Thread::Create(this, TEXT("Steam Network"), ThreadPriority::AboveNormal);
+        return _thread == nullptr;
+    }
+
+    void Shutdown()
+    {
+        if (!_thread)
+            return;
+        Stop();
+        _thread->Join();
+        Delete(_thread);
+        _thread = nullptr;
+    }
+
+public:
+    // [IRunnable]
+    String ToString() const override
+    {
+        return TEXT("SteamNetworkDriverThread");
+    }
+    int32 Run() override
+    {
+        while (Platform::AtomicRead(&_exitRequested) == 0)
+        {
+            _driver->Poll();
+            Platform::Sleep(1);
+        }
+        return 0;
+    }
+    void Stop() override
+    {
+        Platform::InterlockedExchange(&_exitRequested, 1);
+    }
+};
+
+SteamNetworkDriver::SteamNetworkDriver(const SpawnParams& params)
+    : ScriptingObject(params)
+{
+}
+
+bool SteamNetworkDriver::Initialize(NetworkPeer* host, const NetworkConfig& config)
+{
+    _networkHost = host;
+    _config = config;
+    const auto settings = SteamSettings::Get();
+    if (settings->NetworkLoopback)
+    {
+        _loopback = New<SteamNetworkLoopback>();
+        LOG(Info, "Initialized Steam network driver (loopback)");
+        return false;
+    }
+    _sockets = GetNetworkingSockets();
+    _utils = SteamNetworkingUtils();
+    if (!_sockets || !_utils)
+    {
+        LOG(Error, "Steam Networking Sockets are unavailable. Ensure to initialize Steam online platform first.");
+        return true;
+    }
+    const SteamNetworkLane* lanes[LanesCount] = { &settings->UnreliableLane, &settings->UnreliableOrderedLane, &settings->ReliableLane, &settings->ReliableOrderedLane };
+    for (int32 i = 0; i < LanesCount; i++)
+    {
+        _lanePriorities[i] = Math::Max(lanes[i]->Priority, 0);
+        _laneWeights[i] = (uint16)Math::Clamp(lanes[i]->Weight, 1, (int32)MAX_uint16);
+    }
+    _statsInterval = settings->NetworkStatsInterval;
+    _statsHistorySize = _statsInterval > 0.0f ? Math::Max(Math::CeilToInt(settings->NetworkStatsHistory / _statsInterval), 1) : 0;
+    _statsLastTime = 0.0;
+    _sendRate = settings->NetworkSendRate;
+    for (int32 i = 0; i < LanesCount; i++)
+    {
+        _laneCompression[i] = lanes[i]->Compression ? Math::Max(lanes[i]->CompressionThreshold, 0) : -1;
+        _compressionStats[i] = SteamNetworkCompressionStats();
+    }
+    DriversLocker.Lock();
+    Drivers.Add(this);
+    LoadCompressionDictionary();
+    DriversLocker.Unlock();
+    Engine::LateUpdate.Bind<SteamNetworkDriver, &SteamNetworkDriver::OnLateUpdate>(this);
+    if (settings->NetworkThread)
+    {
+        _thread = New<SteamNetworkDriverThread>(this);
+        if (_thread->Start())
+        {
+            LOG(Warning, "Failed to start Steam network thread. Polling on the game thread.");
+            Delete(_thread);
+            _thread = nullptr;
+        }
+    }
+    LOG(Info, "Initialized Steam network driver");
+    return false;
+}
+
+void SteamNetworkDriver::Dispose()
+{
+    if (_loopback)
+    {
+        Delete(_loopback);
+        _loopback = nullptr;
+        _loopbackMessages.Clear();
+        _loopbackData.Clear();
+        _connection = 0;
+        _connections.Clear();
+        _events.Clear();
+        _eventIndex = 0;
+        LOG(Info, "Steam network driver disposed");
+        return;
+    }
+    if (!_sockets)
+        return;
+    Engine::LateUpdate.Unbind<SteamNetworkDriver, &SteamNetworkDriver::OnLateUpdate>(this);
+    if (_thread)
+    {
+        _thread->Shutdown();
+        Delete(_thread);
+        _thread = nullptr;
+    }
+    SubmitOutbox();
+    ReleaseMessages(true);
+    for (SteamNetworkingMessage_t* steamMessage : _inboxMessages)
+        steamMessage->Release();
+    _inboxMessages.Clear();
+    _inboxEvents.Clear();
+    _pendingCloses.Clear();
+    _inboxClosedConnections.Clear();
+    _closedConnections.Clear();
+    _closeEvents.Clear();
+    _closeEventIndex = 0;
+    if (_connection)
+        CloseConnection(_connection, true);
+    for (const uint32 connection : _connections)
+        _sockets->CloseConnection(connection, 0, "Disposed", true);
+    _connections.Clear();
+    _peers.Clear();
+    if (_listenSocket)
+        _sockets->CloseListenSocket(_listenSocket);
+    _listenSocket = 0;
+    if (_pollGroup)
+        _sockets->DestroyPollGroup(_pollGroup);
+    _pollGroup = 0;
+    _events.Clear();
+    _eventIndex = 0;
+    _sockets = nullptr;
+    _utils = nullptr;
+    DriversLocker.Lock();
+    Drivers.Remove(this);
+    LoadCompressionDictionary();
+    _compressionLocker.Lock();
+    _compressionCapture.Clear();
+    _compressionCaptureSize = 0;
+    _compressionLocker.Unlock();
+    if (Drivers.IsEmpty())
+        ClearPayloadPool();
+    DriversLocker.Unlock();
+    LOG(Info, "Steam network driver disposed");
+}
+
+bool SteamNetworkDriver::Listen()
+{
+    if (_loopback)
+    {
+        if (_loopback->Listen(_config.Port, _config.ConnectionsLimit))
+        {
+            LOG(Error, "Failed to listen on loopback port {0}", (int32)_config.Port);
+            return true;
+        }
+        LOG(Info, "Listening on loopback port {0}", (int32)_config.Port);
+        return false;
+    }
+    SteamNetworkingConfigValue_t option;
+    option.SetPtr(k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged, (void*)&OnConnectionStatusChanged);
+    ScopeLock lock(_locker);
+    _pollGroup = _sockets->CreatePollGroup();
+    if (_pollGroup == k_HSteamNetPollGroup_Invalid)
+    {
+        LOG(Error, "Failed to create Steam poll group");
+        _pollGroup = 0;
+        return true;
+    }
+    _listenSocket = _sockets->CreateListenSocketP2P((int32)_config.Port, 1, &option);
+    if (_listenSocket == k_HSteamListenSocket_Invalid)
+    {
+        LOG(Error, "Failed to create Steam P2P listen socket on virtual port {0}", (int32)_config.Port);
+        _sockets->DestroyPollGroup(_pollGroup);
+        _pollGroup = 0;
+        return true;
+    }
+    LOG(Info, "Created Steam P2P listen socket on virtual port {0}", (int32)_config.Port);
+    return false;
+}
+
+bool SteamNetworkDriver::Connect()
+{
+    if (_loopback)
+    {
+        _connection = _loopback->Connect(_config.Port);
+        if (!_connection)
+        {
+            LOG(Error, "Failed to connect to loopback port {0}", (int32)_config.Port);
+            return true;
+        }
+        LOG(Info, "Connected to loopback port {0}", (int32)_config.Port);
+        return false;
+    }
+    uint64 steamId;
+    if (StringUtils::Parse(_config.Address.Get(), _config.Address.Length(), &steamId))
+    {
+        LOG(Error, "Invalid server address '{0}'. Steam network driver requires server SteamID.", _config.Address);
+        return true;
+    }
+    SteamNetworkingIdentity identity;
+    identity.SetSteamID64(steamId);
+    SteamNetworkingConfigValue_t option;
+    option.SetPtr(k_ESteamNetworkingConfig_Callback_ConnectionStatusChanged, (void*)&OnConnectionStatusChanged);
+    ScopeLock lock(_locker);
+    _pollGroup = _sockets->CreatePollGroup();
+    if (_pollGroup == k_HSteamNetPollGroup_Invalid)
+    {
+        LOG(Error, "Failed to create Steam poll group");
+        _pollGroup = 0;
+        return true;
+    }
+    _connectTime = Platform::GetTimeSeconds();
+    if (SteamNetworkSignaling* signaling = AcquireSignaling())
+    {
+        _connection = _sockets->ConnectP2PCustomSignaling(New<SteamSignalingConnection>(signaling, steamId), &identity, (int32)_config.Port, 1, &option);
+        signaling->Release();
+    }
+    else
+        _connection = _sockets->ConnectP2P(identity, (int32)_config.Port, 1, &option);
+    if (_connection == k_HSteamNetConnection_Invalid)
+    {
+        LOG(Error, "Failed to connect to Steam user {0}", steamId);
+        _sockets->DestroyPollGroup(_pollGroup);
+        _pollGroup = 0;
+        return true;
+    }
+    _sockets->SetConnectionPollGroup(_connection, _pollGroup);
+    AddPeer(_connection);
+    LOG(Info, "Connecting to Steam user {0} on virtual port {1}", steamId, (int32)_config.Port);
+    return false;
+}
+
+void SteamNetworkDriver::Disconnect()
+{
+    ScopeLock lock(_locker);
+    if (_connection)
+    {
+        SubmitOutbox();
+        CloseConnection(_connection, true);
+        LOG(Info, "Disconnected");
+    }
+}
+
+void SteamNetworkDriver::Disconnect(const NetworkConnection& connection)
+{
+    ScopeLock lock(_locker);
+    if (HasConnection(connection.ConnectionId))
+    {
+        SubmitOutbox();
+        CloseConnection(connection.ConnectionId, true);
+        LOG(Info, "Disconnected connection with id = {0}", connection.ConnectionId);
+    }
+}
+
+bool SteamNetworkDriver::PopEvent(NetworkEvent& eventPtr)
+{
+    if (_loopback)
+        return PopLoopbackEvent(eventPtr);
+    if (_eventIndex == _events.Count() && _messageIndex == _messages.Count() && _closeEventIndex == _closeEvents.Count())
+    {
+        // Dispatch connection status callbacks and receive messages (network thread does it on its own)
+        _events.Clear();
+        _eventIndex = 0;
+        _closeEvents.Clear();
+        _closeEventIndex = 0;
+        _receivedMessages.Add(_messages);
+        _messages.Clear();
+        _messageIndex = 0;
+        if (!_thread)
+        {
+            ReceiveSignals();
+            _sockets->RunCallbacks();
+            if (Receive())
+            {
+                // Poll group got drained so the closed connections have no more messages to receive
+                ScopeLock lock(_locker);
+                ClosePendingConnections();
+            }
+        }
+        ScopeLock lock(_locker);
+
+        // Free the slots of the peers closed in the previous batch (all their messages were popped)
+        for (Peer& peer : _peers)
+        {
+            if (peer.Connection && _closedConnections.Contains(peer.Connection))
+                peer.Connection = 0;
+        }
+        _closedConnections.Clear();
+        _closedConnections.Add(_inboxClosedConnections);
+        _inboxClosedConnections.Clear();
+
+        if (_thread)
+        {
+            _messages.Add(_inboxMessages);
+            _inboxMessages.Clear();
+        }
+        for (const NetworkEvent& e : _inboxEvents)
+        {
+            if (e.EventType == NetworkEventType::Connected)
+                _events.Add(e);
+            else
+                _closeEvents.Add(e);
+        }
+        _inboxEvents.Clear();
+    }
+
+    // New connections (before their messages)
+    if (_eventIndex < _events.Count())
+    {
+        eventPtr = _events[_eventIndex++];
+        return true;
+    }
+
+    // Messages (decoded in place from Steam buffers that are released all at once on late update)
+    ScopeLock lock(_locker);
+    while (_messageIndex < _messages.Count())
+    {
+        const SteamNetworkingMessage_t* steamMessage = _messages[_messageIndex++];
+        const int64 peerIndex = steamMessage->m_nConnUserData;
+        if (peerIndex < 0 || peerIndex >= _peers.Count() || _peers[(int32)peerIndex].Connection != steamMessage->m_conn)
+        {
+            // Connection got closed after receiving the message
+            continue;
+        }
+        Peer& peer = _peers[(int32)peerIndex];
+        NetworkMessage message = _networkHost->CreateMessage();
+        if (Decode(steamMessage, message))
+        {
+            LOG(Warning, "Received invalid message ({0} bytes) from connection with id = {1}", steamMessage->m_cbSize, peer.Connection);
+            _networkHost->RecycleMessage(message);
+            continue;
+        }
+        eventPtr.EventType = NetworkEventType::Message;
+        eventPtr.Message = message;
+        eventPtr.Sender.ConnectionId = peer.Connection;
+        peer.TotalDataReceived += steamMessage->m_cbSize;
+        _totalDataReceived += steamMessage->m_cbSize;
+        return true;
+    }
+
+    // Closed connections (after the messages that peers sent before disconnecting)
+    if (_closeEventIndex < _closeEvents.Count())
+    {
+        eventPtr = _closeEvents[_closeEventIndex++];
+        return true;
+    }
+
+    return false;
+}
+
+void SteamNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message)
+{
+    NetworkConnection target;
+    target.ConnectionId = _connection;
+    Send(&target, 1, channelType, message);
+}
+
+void SteamNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message, NetworkConnection target)
+{
+    Send(&target, 1, channelType, message);
+}
+
+void SteamNetworkDriver::SendMessage(const NetworkChannelType channelType, const NetworkMessage& message, const Array<NetworkConnection, HeapAllocation>& targets)
+{
+    Send(targets.Get(), targets.Count(), channelType, message);
+}
+
+NetworkDriverStats SteamNetworkDriver::GetStats()
+{
+    NetworkConnection target;
+    target.ConnectionId = _connection;
+    return GetStats(target);
+}
+
+NetworkDriverStats SteamNetworkDriver::GetStats(NetworkConnection target)
+{
+    ScopeLock lock(_locker);
+    NetworkDriverStats stats;
+    SteamNetConnectionRealTimeStatus_t status;
+    if (target.ConnectionId && _sockets && _sockets->GetConnectionRealTimeStatus(target.ConnectionId, &status, 0, nullptr) == k_EResultOK)
+        stats.RTT = (float)status.m_nPing;
+    const Peer* peer = _sockets ? GetPeer(target.ConnectionId) : nullptr;
+    stats.TotalDataSent = (uint32)Platform::AtomicRead(&_totalDataSent);
+    stats.TotalDataReceived = peer ? peer->TotalDataReceived : _totalDataReceived;
+    return stats;
+}
+
+bool SteamNetworkDriver::GetLaneStatus(const NetworkConnection& connection, NetworkChannelType channelType, SteamNetworkLaneStatus& status)
+{
+    ScopeLock lock(_locker);
+    SteamNetConnectionRealTimeLaneStatus_t lanes[LanesCount];
+    if (!_sockets || !HasConnection(connection.ConnectionId) || _sockets->GetConnectionRealTimeStatus(connection.ConnectionId, nullptr, LanesCount, lanes) != k_EResultOK)
+        return true;
+    const SteamNetConnectionRealTimeLaneStatus_t& lane = lanes[GetLane(channelType)];
+    status.PendingUnreliable = lane.m_cbPendingUnreliable;
+    status.PendingReliable = lane.m_cbPendingReliable;
+    status.SentUnackedReliable = lane.m_cbSentUnackedReliable;
+    status.QueueTime = (float)((double)lane.m_usecQueueTime * 0.001);
+    return false;
+}
+
+bool SteamNetworkDriver::GetConnectionStats(const NetworkConnection& connection, SteamNetworkConnectionStats& stats)
+{
+    ScopeLock lock(_locker);
+    const Peer* peer = _sockets ? GetPeer(connection.ConnectionId) : nullptr;
+    if (!peer || peer->StatsHistory.IsEmpty())
+        return true;
+    const int32 last = (peer->StatsHistoryStart + peer->StatsHistory.Count() - 1) % peer->StatsHistory.Count();
+    stats = peer->StatsHistory[last];
+    return false;
+}
+
+bool SteamNetworkDriver::GetConnectionStatsHistory(const NetworkConnection& connection, Array<SteamNetworkConnectionStats>& history)
+{
+    ScopeLock lock(_locker);
+    const Peer* peer = _sockets ? GetPeer(connection.ConnectionId) : nullptr;
+    if (!peer)
+        return true;
+    const int32 count = peer->StatsHistory.Count();
+    history.Resize(count);
+    for (int32 i = 0; i < count; i++)
+        history[i] = peer->StatsHistory[(peer->StatsHistoryStart + i) % count];
+    return false;
+}
+
+String SteamNetworkDriver::GetConnectionDetailedStatus(const NetworkConnection& connection)
+{
+    ScopeLock lock(_locker);
+    if (!_sockets || !HasConnection(connection.ConnectionId))
+        return String::Empty;
+    Array<char> buffer;
+    buffer.Resize(2048);
+    int32 result = _sockets->GetDetailedConnectionStatus(connection.ConnectionId, buffer.Get(), buffer.Count());
+    if (result > 0)
+    {
+        buffer.Resize(result);
+        result = _sockets->GetDetailedConnectionStatus(connection.ConnectionId, buffer.Get(), buffer.Count());
+    }
+    return result == 0 ? String(buffer.Get()) : String::Empty;
+}
+
+bool SteamNetworkDriver::SetImpairment(const SteamNetworkImpairment& impairment)
+{
+    if (SetImpairmentConfig(k_ESteamNetworkingConfig_Global, 0, impairment))
+    {
+        LOG(Warning, "Failed to set Steam network impairment");
+        return true;
+    }
+    LOG(Info, "Steam network impairment: loss {0}%/{1}%, lag {2}/{3} ms, reorder {4}%/{5}% (send/receive)", impairment.PacketLossSend, impairment.PacketLossRecv, impairment.PacketLagSend, impairment.PacketLagRecv, impairment.PacketReorderSend, impairment.PacketReorderRecv);
+    return false;
+}
+
+bool SteamNetworkDriver::SetConnectionImpairment(const NetworkConnection& connection, const SteamNetworkImpairment& impairment)
+{
+    ScopeLock lock(_locker);
+    if (!_sockets || !HasConnection(connection.ConnectionId))
+        return true;
+    return SetImpairmentConfig(k_ESteamNetworkingConfig_Connection, (intptr_t)connection.ConnectionId, impairment);
+}
+
+bool SteamNetworkDriver::SetConnectionSendRate(const NetworkConnection& connection, const SteamNetworkSendRate& sendRate)
+{
+    ScopeLock lock(_locker);
+    Peer* peer = _sockets ? GetPeer(connection.ConnectionId) : nullptr;
+    if (!peer)
+        return true;
+    peer->SendRate = sendRate;
+    return ApplySendRate(*peer);
+}
+
+bool SteamNetworkDriver::GetSendRateStatus(const NetworkConnection& connection, SteamNetworkSendRateStatus& status)
+{
+    ScopeLock lock(_locker);
+    const Peer* peer = _sockets ? GetPeer(connection.ConnectionId) : nullptr;
+    if (!peer)
+        return true;
+    status = peer->SendRateStatus;
+    return false;
+}
+
+bool SteamNetworkDriver::GetCompressionStats(NetworkChannelType channelType, SteamNetworkCompressionStats& stats)
+{
+    const int32 lane = GetLane(channelType);
+    if (!_sockets || _laneCompression[lane] < 0)
+        return true;
+    ScopeLock lock(_compressionLocker);
+    stats = _compressionStats[lane];
+    return false;
+}
+
+void SteamNetworkDriver::CaptureCompressionSamples(int32 size)
+{
+    ScopeLock lock(_compressionLocker);
+    _compressionCapture.Clear();
+    _compressionCaptureSize = Math::Max(size, 0);
+}
+
+bool SteamNetworkDriver::BuildCompressionDictionary(Array<byte>& dictionary)
+{
+    ScopeLock lock(_compressionLocker);
+    _compressionCaptureSize = 0;
+    if (_compressionCapture.IsEmpty())
+        return true;
+
+    // LZ4 dictionary is a prefix of the compressed data so use the latest messages (matches at closer offsets are cheaper)
+    const int32 size = Math::Min(_compressionCapture.Count(), MaxCompressionDictionarySize);
+    dictionary.Set(_compressionCapture.Get() + _compressionCapture.Count() - size, size);
+    _compressionCapture.Clear();
+    return false;
+}
+
+void SteamNetworkDriver::SetCompressionDictionary(const Array<byte>& dictionary)
+{
+    ScopeLock lock(DriversLocker);
+    const int32 size = Math::Min(dictionary.Count(), MaxCompressionDictionarySize);
+    CompressionDictionary.Set(dictionary.Get() + dictionary.Count() - size, size);
+    for (SteamNetworkDriver* driver : Drivers)
+        driver->LoadCompressionDictionary();
+}
+
+void SteamNetworkDriver::SetSignaling(SteamNetworkSignaling* signaling)
+{
+    if (signaling)
+        signaling->AddRef();
+    SteamNetworkSignaling* prev;
+    {
+        ScopeLock lock(SignalingLocker);
+        prev = Signaling;
+        Signaling = signaling;
+    }
+    if (prev)
+        prev->Release();
+}
+
+bool SteamNetworkDriver::HasConnection(uint32 connection) const
+{
+    return connection != 0 && (connection == _connection || _connections.Contains(connection));
+}
+
+void SteamNetworkDriver::AddPeer(uint32 connection)
+{
+    int32 index = 0;
+    while (index < _peers.Count() && _peers[index].Connection != 0)
+        index++;
+    if (index == _peers.Count())
+        _peers.AddOne();
+    Peer& peer = _peers[index];
+    peer.Connection = connection;
+    peer.TotalDataReceived = 0;
+    peer.StatsHistory.Clear();
+    peer.StatsHistoryStart = 0;
+    peer.SendRate = _sendRate;
+    _sockets->SetConnectionUserData(connection, index);
+    if (_sockets->ConfigureConnectionLanes(connection, LanesCount, _lanePriorities, _laneWeights) != k_EResultOK)
+        LOG(Warning, "Failed to configure lanes for connection with id = {0}", connection);
+    if (ApplySendRate(peer))
+        LOG(Warning, "Failed to configure send rate for connection with id = {0}", connection);
+}
+
+SteamNetworkDriver::Peer* SteamNetworkDriver::GetPeer(uint32 connection)
+{
+    if (!connection)
+        return nullptr;
+    const int64 index = _sockets->GetConnectionUserData(connection);
+    return index >= 0 && index < _peers.Count() && _peers[(int32)index].Connection == connection ? &_peers[(int32)index] : nullptr;
+}
+
+void SteamNetworkDriver::CloseConnection(uint32 connection, bool linger)
+{
+    if (_loopback)
+    {
+        _loopback->Disconnect(connection);
+    }
+    else
+    {
+        if (Peer* peer = GetPeer(connection))
+            peer->Connection = 0;
+        _sockets->CloseConnection(connection, 0, nullptr, linger);
+    }
+    if (connection == _connection)
+        _connection = 0;
+    else
+        _connections.Remove(connection);
+}
+
+void SteamNetworkDriver::LoadCompressionDictionary()
+{
+    // Dictionary is loaded into the stream once and the stream state gets copied for every compressed message
+    ScopeLock lock(_compressionLocker);
+    const bool use = Drivers.Contains(this) && CompressionDictionary.HasItems();
+    _compressionDictionary = use ? CompressionDictionary : Array<byte>();
+    _compressionDictionaryId = use ? GetDictionaryId(_compressionDictionary) : 0;
+    if (use && !_compressionDictionaryStream)
+    {
+        _compressionDictionaryStream = LZ4_createStream();
+        _compressionStream = LZ4_createStream();
+    }
+    else if (!use && _compressionDictionaryStream)
+    {
+        LZ4_freeStream((LZ4_stream_t*)_compressionDictionaryStream);
+        LZ4_freeStream((LZ4_stream_t*)_compressionStream);
+        _compressionDictionaryStream = nullptr;
+        _compressionStream = nullptr;
+    }
+    if (use)
+        LZ4_loadDict((LZ4_stream_t*)_compressionDictionaryStream, (const char*)_compressionDictionary.Get(), _compressionDictionary.Count());
+}
+
+int32 SteamNetworkDriver::Encode(int32 lane, const NetworkMessage& message, byte* data)
+{
+    // Messages can be sent from multiple threads while compression stream state is shared
+    ScopeLock lock(_compressionLocker);
+    SteamNetworkCompressionStats& stats = _compressionStats[lane];
+    const int32 length = (int32)message.Length;
+    if (_compressionCaptureSize > _compressionCapture.Count())
+        _compressionCapture.Add(message.Buffer, Math::Min(length, _compressionCaptureSize - _compressionCapture.Count()));
+    stats.BytesIn += length;
+    if (length >= _laneCompression[lane] && length > 0)
+    {
+        // Compress data (use it only if it's smaller than raw data)
+        const double startTime = Platform::GetTimeSeconds();
+        int32 headerSize, compressedSize;
+        if (_compressionStream)
+        {
+            data[0] = (byte)PayloadFormat::LZ4Dictionary;
+            Platform::MemoryCopy(data + 1, &_compressionDictionaryId, sizeof(uint32));
+            headerSize = 1 + sizeof(uint32);
+            Platform::MemoryCopy(_compressionStream, _compressionDictionaryStream, sizeof(LZ4_stream_t));
+            compressedSize = LZ4_compress_fast_continue((LZ4_stream_t*)_compressionStream, (const char*)message.Buffer, (char*)data + headerSize, length, LZ4_compressBound(length), 1);
+        }
+        else
+        {
+            data[0] = (byte)PayloadFormat::LZ4;
+            headerSize = 1;
+            compressedSize = LZ4_compress_default((const char*)message.Buffer, (char*)data + headerSize, length, LZ4_compressBound(length));
+        }
+        stats.CompressTime += (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+        if (compressedSize > 0 && headerSize + compressedSize < 1 + length)
+        {
+            stats.MessagesCompressed++;
+            stats.BytesOut += headerSize + compressedSize;
+            return headerSize + compressedSize;
+        }
+    }
+    data[0] = (byte)PayloadFormat::Raw;
+    Platform::MemoryCopy(data + 1, message.Buffer, length);
+    stats.MessagesRaw++;
+    stats.BytesOut += 1 + length;
+    return 1 + length;
+}
+
+bool SteamNetworkDriver::Decode(const SteamNetworkingMessage_t* steamMessage, NetworkMessage& message)
+{
+    byte* data = (byte*)steamMessage->m_pData;
+    int32 size = steamMessage->m_cbSize;
+    const int32 lane = steamMessage->m_idxLane;
+    if (lane < LanesCount && _laneCompression[lane] >= 0)
+    {
+        if (size < 1)
+            return true;
+        const PayloadFormat format = (PayloadFormat)data[0];
+        data++;
+        size--;
+        if (format != PayloadFormat::Raw)
+        {
+            // Decompress into the network message buffer
+            ScopeLock lock(_compressionLocker);
+            SteamNetworkCompressionStats& stats = _compressionStats[lane];
+            const double startTime = Platform::GetTimeSeconds();
+            int32 decompressedSize = -1;
+            if (format == PayloadFormat::LZ4)
+            {
+                decompressedSize = LZ4_decompress_safe((const char*)data, (char*)message.Buffer, size, (int32)message.BufferSize);
+            }
+            else if (format == PayloadFormat::LZ4Dictionary && size >= (int32)sizeof(uint32))
+            {
+                // Sender has to use the same dictionary (LZ4 doesn't detect the mismatch on its own)
+                uint32 dictionaryId;
+                Platform::MemoryCopy(&dictionaryId, data, sizeof(uint32));
+                if (_compressionDictionary.HasItems() && dictionaryId == _compressionDictionaryId)
+                    decompressedSize = LZ4_decompress_safe_usingDict((const char*)data + sizeof(uint32), (char*)message.Buffer, size - (int32)sizeof(uint32), (int32)message.BufferSize, (const char*)_compressionDictionary.Get(), _compressionDictionary.Count());
+                else
+                    LOG(Warning, "Received message compressed with a different dictionary (id: {0}, local id: {1})", dictionaryId, _compressionDictionaryId);
+            }
+            stats.DecompressTime += (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+            if (decompressedSize < 0)
+                return true;
+            stats.MessagesDecompressed++;
+            message.Length = decompressedSize;
+            return false;
+        }
+    }
+
+    // Use the Steam buffer in place
+    if (size > 0)
+    {
+        message.Buffer = data;
+        message.BufferSize = size;
+        message.Length = size;
+    }
+    return false;
+}
+
+void SteamNetworkDriver::Send(const NetworkConnection* targets, int32 targetsCount, NetworkChannelType channelType, const NetworkMessage& message)
+{
+    if (_loopback)
+    {
+        for (int32 i = 0; i < targetsCount; i++)
+        {
+            if (!_loopback->Send(targets[i].ConnectionId, message.Buffer, (int32)message.Length))
+                Platform::InterlockedAdd(&_totalDataSent, (int64)message.Length);
+        }
+        return;
+    }
+
+    // Copy (or compress) message data once into payload shared by all targets
+    const int32 lane = GetLane(channelType);
+    const bool compress = _laneCompression[lane] >= 0;
+    SendPayload* payload = AllocatePayload(compress ? MaxPayloadHeaderSize + LZ4_compressBound((int32)message.Length) : (int32)message.Length);
+    byte* data = (byte*)(payload + 1);
+    int32 size = (int32)message.Length;
+    if (compress)
+        size = Encode(lane, message, data);
+    else
+        Platform::MemoryCopy(data, message.Buffer, message.Length);
+    const int32 flags = GetSendFlags(channelType);
+    Array<SteamNetworkingMessage_t*, InlinedAllocation<16>> steamMessages;
+    for (int32 i = 0; i < targetsCount; i++)
+    {
+        const uint32 connection = targets[i].ConnectionId;
+        if (!connection)
+            continue;
+        SteamNetworkingMessage_t* steamMessage = _utils->AllocateMessage(0);
+        if (!steamMessage)
+            break;
+        steamMessage->m_conn = connection;
+        steamMessage->m_pData = data;
+        steamMessage->m_cbSize = size;
+        steamMessage->m_nFlags = flags;
+        steamMessage->m_idxLane = (uint16)lane;
+        steamMessage->m_pfnFreeData = OnFreeMessageData;
+        steamMessage->m_nUserData = (int64)payload;
+        steamMessages.Add(steamMessage);
+    }
+    if (steamMessages.IsEmpty())
+    {
+        FreePayload(payload);
+        return;
+    }
+
+    // Reference count has to be set before the messages get visible to the network thread (it can send and free them right away)
+    payload->RefCount = steamMessages.Count();
+    _outboxLocker.Lock();
+    _outbox.Add(steamMessages.Get(), steamMessages.Count());
+    _outboxLocker.Unlock();
+}
+
+void SteamNetworkDriver::OnLateUpdate()
+{
+    ReleaseMessages(false);
+    Flush();
+    const double time = Platform::GetTimeSeconds();
+    if (time - _sendRateLastTime >= AdaptiveSendRateInterval)
+        UpdateSendRates();
+    if (_statsInterval > 0.0f && time - _statsLastTime >= _statsInterval)
+        SampleStats();
+}
+
+void SteamNetworkDriver::Flush()
+{
+    if (_thread)
+        Platform::InterlockedExchange(&_flushRequested, 1);
+    else
+        SubmitOutbox();
+}
+
+void SteamNetworkDriver::SubmitOutbox()
+{
+    ScopeLock lock(_outboxLocker);
+    if (_outbox.IsEmpty())
+        return;
+    PROFILE_CPU();
+
+    // Submit all queued messages at once (Steam takes ownership of them so sizes are read before)
+    const int32 count = _outbox.Count();
+    _outboxSizes.Resize(count, false);
+    for (int32 i = 0; i < count; i++)
+        _outboxSizes[i] = _outbox[i]->m_cbSize;
+    _outboxResults.Resize(count, false);
+    _sockets->SendMessages(count, _outbox.Get(), _outboxResults.Get());
+    _outbox.Clear();
+    int64 dataSent = 0;
+    for (int32 i = 0; i < count; i++)
+    {
+        if (_outboxResults[i] < 0)
+        {
+            LOG(Warning, "Failed to send message (result: {0})", (int32)-_outboxResults[i]);
+            continue;
+        }
+        dataSent += _outboxSizes[i];
+    }
+
+    // Stats are read by the game thread while outbox can be submitted on the network thread
+    Platform::InterlockedAdd(&_totalDataSent, dataSent);
+}
+
+void SteamNetworkDriver::SampleStats()
+{
+    PROFILE_CPU();
+    _statsLastTime = Platform::GetTimeSeconds();
+    ScopeLock lock(_locker);
+    int32 maxPing = 0, pendingBytes = 0, sendRate = 0;
+    float minQuality = 1.0f, maxQueueTime = 0.0f;
+    int64 adaptiveSendRate = 0;
+    for (Peer& peer : _peers)
+    {
+        SteamNetConnectionRealTimeStatus_t status;
+        if (!peer.Connection || _sockets->GetConnectionRealTimeStatus(peer.Connection, &status, 0, nullptr) != k_EResultOK)
+            continue;
+        SteamNetworkConnectionStats stats;
+        stats.Time = (float)_statsLastTime;
+        stats.Ping = status.m_nPing;
+        stats.QualityLocal = status.m_flConnectionQualityLocal;
+        stats.QualityRemote = status.m_flConnectionQualityRemote;
+        stats.OutBytesPerSec = status.m_flOutBytesPerSec;
+        stats.InBytesPerSec = status.m_flInBytesPerSec;
+        stats.SendRate = status.m_nSendRateBytesPerSecond;
+        stats.PendingBytes = status.m_cbPendingUnreliable + status.m_cbPendingReliable;
+        stats.SentUnackedReliable = status.m_cbSentUnackedReliable;
+        stats.QueueTime = (float)((double)status.m_usecQueueTime * 0.001);
+
+        // Ring buffer of the samples
+        if (peer.StatsHistory.Count() < _statsHistorySize)
+        {
+            peer.StatsHistory.Add(stats);
+        }
+        else
+        {
+            peer.StatsHistory[peer.StatsHistoryStart] = stats;
+            peer.StatsHistoryStart = (peer.StatsHistoryStart + 1) % peer.StatsHistory.Count();
+        }
+
+        if (peer.SendRate.Adaptive)
+            adaptiveSendRate += peer.SendRateStatus.SendRate;
+
+        maxPing = Math::Max(maxPing, stats.Ping);
+        if (stats.QualityLocal >= 0.0f)
+            minQuality = Math::Min(minQuality, stats.QualityLocal);
+        maxQueueTime = Math::Max(maxQueueTime, stats.QueueTime);
+        pendingBytes += stats.PendingBytes;
+        sendRate += stats.SendRate;
+    }
+
+#if COMPILE_WITH_PROFILER
+    // Worst values across all connections
+    TracyPlot("Steam Ping (ms)", (int64)maxPing);
+    TracyPlot("Steam Packet Loss (%)", (1.0f - minQuality) * 100.0f);
+    TracyPlot("Steam Queue Time (ms)", maxQueueTime);
+    TracyPlot("Steam Pending Bytes", (int64)pendingBytes);
+    TracyPlot("Steam Send Rate (B/s)", (int64)sendRate);
+    TracyPlot("Steam Adaptive Send Rate (B/s)", adaptiveSendRate);
+    int64 compressionSaved = 0;
+    _compressionLocker.Lock();
+    for (const SteamNetworkCompressionStats& e : _compressionStats)
+        compressionSaved += e.BytesIn - e.BytesOut;
+    _compressionLocker.Unlock();
+    TracyPlot("Steam Compression Saved (B)", compressionSaved);
+#endif
+}
+
+bool SteamNetworkDriver::ApplySendRate(Peer& peer)
+{
+    const SteamNetworkSendRate& sendRate = peer.SendRate;
+    SteamNetworkSendRateStatus& status = peer.SendRateStatus;
+    status = SteamNetworkSendRateStatus();
+    if (!sendRate.Adaptive)
+        return SetSendRateConfig(_utils, peer.Connection, sendRate.SendRateMin, sendRate.SendRateMax, sendRate.NagleTime);
+
+    // Start from the minimum rate and let the controller raise it
+    status.Adaptive = true;
+    status.SendRate = sendRate.SendRateMin > 0 ? sendRate.SendRateMin : AdaptiveSendRateMin;
+    return SetSendRateConfig(_utils, peer.Connection, status.SendRate, status.SendRate, sendRate.NagleTime);
+}
+
+void SteamNetworkDriver::UpdateSendRates()
+{
+    _sendRateLastTime = Platform::GetTimeSeconds();
+    ScopeLock lock(_locker);
+    for (Peer& peer : _peers)
+    {
+        SteamNetConnectionRealTimeStatus_t status;
+        if (!peer.Connection || !peer.SendRate.Adaptive || _sockets->GetConnectionRealTimeStatus(peer.Connection, &status, 0, nullptr) != k_EResultOK)
+            continue;
+        UpdateSendRate(peer, (float)((double)status.m_usecQueueTime * 0.001));
+    }
+}
+
+void SteamNetworkDriver::UpdateSendRate(Peer& peer, float queueTime)
+{
+    const SteamNetworkSendRate& sendRate = peer.SendRate;
+    SteamNetworkSendRateStatus& status = peer.SendRateStatus;
+    const int32 minRate = sendRate.SendRateMin > 0 ? sendRate.SendRateMin : AdaptiveSendRateMin;
+    const int32 maxRate = Math::Max(sendRate.SendRateMax > 0 ? sendRate.SendRateMax : AdaptiveSendRateMax, minRate);
+    status.QueueTime = queueTime;
+
+    // Raise the rate gradually while the queue stays short and back off quickly when it grows
+    int32 rate = status.SendRate;
+    if (queueTime <= sendRate.TargetQueueTime * 0.5f)
+        rate = (int32)Math::Min((int64)rate * 5 / 4, (int64)maxRate);
+    else if (queueTime > sendRate.TargetQueueTime)
+        rate = Math::Max(rate * 3 / 4, minRate);
+    if (rate == status.SendRate)
+        return;
+    if (rate > status.SendRate)
+        status.Increases++;
+    else
+        status.Decreases++;
+    status.SendRate = rate;
+
+    // Fixed rate (Steam bandwidth estimation stays within the min-max range)
+    SetSendRateConfig(_utils, peer.Connection, rate, rate, sendRate.NagleTime);
+}
+
+bool SteamNetworkDriver::Receive()
+{
+    // Returns true if all messages were received from the poll group
+    PROFILE_CPU();
+    if (!_pollGroup)
+        return true;
+    _messages.Resize(MaxReceivedMessages, false);
+    const int32 count = _sockets->ReceiveMessagesOnPollGroup(_pollGroup, _messages.Get(), MaxReceivedMessages);
+    _messages.Resize(Math::Max(count, 0), false);
+    return count < MaxReceivedMessages;
+}
+
+void SteamNetworkDriver::ClosePendingConnections()
+{
+    // Called once the poll group got drained so the messages received before closing are already in the inbox
+    for (const PendingClose& e : _pendingCloses)
+    {
+        if (!HasConnection(e.Connection))
+            continue;
+        _sockets->CloseConnection(e.Connection, 0, nullptr, false);
+        if (e.Connection == _connection)
+            _connection = 0;
+        else
+            _connections.Remove(e.Connection);
+
+        // Peer slot is kept until its messages get popped (freed on the next batch)
+        _inboxClosedConnections.Add(e.Connection);
+        auto& event = _inboxEvents.AddOne();
+        event.EventType = e.EventType;
+        event.Sender.ConnectionId = e.Connection;
+    }
+    _pendingCloses.Clear();
+}
+
+void SteamNetworkDriver::Poll()
+{
+    PROFILE_CPU();
+    if (Platform::InterlockedExchange(&_flushRequested, 0))
+        SubmitOutbox();
+    ReceiveSignals();
+    _sockets->RunCallbacks();
+
+    // Drain the poll group into the inbox (consumed by the game thread, poll group is created by the game thread so it's accessed under the lock)
+    ScopeLock lock(_locker);
+    if (_pollGroup)
+    {
+        SteamNetworkingMessage_t* messages[MaxReceivedMessages];
+        int32 count;
+        do
+        {
+            count = _sockets->ReceiveMessagesOnPollGroup(_pollGroup, messages, MaxReceivedMessages);
+            if (count <= 0)
+                break;
+            _inboxMessages.Add(messages, count);
+        } while (count == MaxReceivedMessages);
+    }
+    ClosePendingConnections();
+}
+
+void SteamNetworkDriver::ReleaseMessages(bool all)
+{
+    if (_receivedMessages.IsEmpty() && _messages.IsEmpty())
+        return;
+    PROFILE_CPU();
+
+    // Received messages are referenced by the network messages until the end of the frame so release them in a single sweep
+    for (SteamNetworkingMessage_t* steamMessage : _receivedMessages)
+        steamMessage->Release();
+    _receivedMessages.Clear();
+    if (all || _messageIndex == _messages.Count())
+    {
+        for (SteamNetworkingMessage_t* steamMessage : _messages)
+            steamMessage->Release();
+        _messages.Clear();
+        _messageIndex = 0;
+    }
+}
+
+bool SteamNetworkDriver::PopLoopbackEvent(NetworkEvent& eventPtr)
+{
+    if (_messageIndex == _loopbackMessages.Count())
+    {
+        _loopbackMessages.Clear();
+        _loopbackData.Clear();
+        _messageIndex = 0;
+        _loopback->Pop(_loopbackMessages, _loopbackData);
+    }
+
+    // Connection changes and messages in the order they were sent (messages sent before disconnecting are still delivered)
+    while (_messageIndex < _loopbackMessages.Count())
+    {
+        const SteamNetworkLoopback::Message& loopbackMessage = _loopbackMessages[_messageIndex++];
+        const uint32 connection = loopbackMessage.Connection;
+        if (loopbackMessage.EventType != NetworkEventType::Message)
+        {
+            if (loopbackMessage.EventType == NetworkEventType::Connected)
+            {
+                if (connection != _connection)
+                    _connections.Add(connection);
+            }
+            else if (connection == _connection)
+                _connection = 0;
+            else
+                _connections.Remove(connection);
+            eventPtr.EventType = loopbackMessage.EventType;
+            eventPtr.Sender.ConnectionId = connection;
+            return true;
+        }
+        if (!HasConnection(connection))
+            continue;
+        NetworkMessage message = _networkHost->CreateMessage();
+        if ((uint32)loopbackMessage.Length > message.BufferSize)
+        {
+            LOG(Warning, "Received too big message ({0} bytes) from connection with id = {1}", loopbackMessage.Length, loopbackMessage.Connection);
+            _networkHost->RecycleMessage(message);
+            continue;
+        }
+        Platform::MemoryCopy(message.Buffer, _loopbackData.Get() + loopbackMessage.Offset, loopbackMessage.Length);
+        message.Length = loopbackMessage.Length;
+        eventPtr.EventType = NetworkEventType::Message;
+        eventPtr.Message = message;
+        eventPtr.Sender.ConnectionId = loopbackMessage.Connection;
+        _totalDataReceived += loopbackMessage.Length;
+        return true;
+    }
+
+    return false;
+}
+
+void SteamNetworkDriver::ReceiveSignals()
+{
+    SteamNetworkSignaling* signaling = AcquireSignaling();
+    if (!signaling)
+        return;
+    PROFILE_CPU();
+    SteamSignalingRecvContext context(this, signaling);
+    while (signaling->PopSignal(_signal))
+        _sockets->ReceivedP2PCustomSignal(_signal.Get(), _signal.Count(), &context);
+    signaling->Release();
+}
+
+void SteamNetworkDriver::OnConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t* data)
+{
+    ScopeLock lock(DriversLocker);
+    for (SteamNetworkDriver* driver : Drivers)
+    {
+        ScopeLock driverLock(driver->_locker);
+        if ((driver->_listenSocket && driver->_listenSocket == data->m_info.m_hListenSocket) || driver->HasConnection(data->m_hConn) || driver->_signaledConnections.Contains(data->m_hConn))
+        {
+            driver->ConnectionStatusChanged(data);
+            break;
+        }
+    }
+}
+
+void SteamNetworkDriver::ConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t* data)
+{
+    ScopeLock lock(_locker);
+    const uint32 connection = data->m_hConn;
+    _signaledConnections.Remove(connection);
+    switch (data->m_info.m_eState)
+    {
+    case k_ESteamNetworkingConnectionState_Connecting:
+        if (IsServer() && !_connections.Contains(connection))
+        {
+            // Accept incoming connection
+            if (_connections.Count() >= _config.ConnectionsLimit)
+            {
+                _sockets->CloseConnection(connection, k_ESteamNetConnectionEnd_App_Generic, "Server full", false);
+                break;
+            }
+            if (_sockets->AcceptConnection(connection) != k_EResultOK)
+            {
+                _sockets->CloseConnection(connection, 0, nullptr, false);
+                break;
+            }
+            _sockets->SetConnectionPollGroup(connection, _pollGroup);
+            _connections.Add(connection);
+            AddPeer(connection);
+        }
+        break;
+    case k_ESteamNetworkingConnectionState_Connected:
+    {
+        if (connection == _connection)
+            LOG(Info, "Connected to Steam user in {0} ms", (int32)((Platform::GetTimeSeconds() - _connectTime) * 1000.0));
+        auto& e = _inboxEvents.AddOne();
+        e.EventType = NetworkEventType::Connected;
+        e.Sender.ConnectionId = connection;
+        break;
+    }
+    case k_ESteamNetworkingConnectionState_ClosedByPeer:
+    case k_ESteamNetworkingConnectionState_ProblemDetectedLocally:
+    {
+        if (data->m_eOldState == k_ESteamNetworkingConnectionState_Connected)
+        {
+            // Close the connection after receiving the messages that peer sent before disconnecting
+            auto& e = _pendingCloses.AddOne();
+            e.Connection = connection;
+            e.EventType = data->m_info.m_eState == k_ESteamNetworkingConnectionState_ClosedByPeer ? NetworkEventType::Disconnected : NetworkEventType::Timeout;
+        }
+        else
+        {
+            LOG(Warning, "Steam connection failed: {0}", String(data->m_info.m_szEndDebug));
+            CloseConnection(connection, false);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+#endif
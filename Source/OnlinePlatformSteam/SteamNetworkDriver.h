@@ -0,0 +1,420 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Networking/Types.h"
+#include "Engine/Networking/INetworkDriver.h"
+#include "Engine/Networking/NetworkConnection.h"
+#include "Engine/Networking/NetworkConfig.h"
+#include "Engine/Networking/NetworkEvent.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Scripting/ScriptingObject.h"
+#include "OnlinePlatformSteam.h"
+#include "SteamNetworkLoopback.h"
+
+class ISteamNetworkingSockets;
+class ISteamNetworkingUtils;
+struct SteamNetworkingMessage_t;
+struct SteamNetConnectionStatusChangedCallback_t;
+class SteamNetworkSignaling;
+
+/// <summary>
+/// The real-time status of the Steam network connection lane (see SteamSettings for lanes configuration).
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkLaneStatus
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkLaneStatus);
+
+    /// <summary>
+    /// The amount of bytes of unreliable messages waiting to be sent.
+    /// </summary>
+    API_FIELD() int32 PendingUnreliable = 0;
+
+    /// <summary>
+    /// The amount of bytes of reliable messages waiting to be sent.
+    /// </summary>
+    API_FIELD() int32 PendingReliable = 0;
+
+    /// <summary>
+    /// The amount of bytes of reliable messages sent but not yet acknowledged.
+    /// </summary>
+    API_FIELD() int32 SentUnackedReliable = 0;
+
+    /// <summary>
+    /// The estimated time (in milliseconds) that a message sent now on this lane would wait in the queue before being sent.
+    /// </summary>
+    API_FIELD() float QueueTime = 0.0f;
+};
+
+/// <summary>
+/// The sample of the Steam network connection real-time statistics.
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkConnectionStats
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkConnectionStats);
+
+    /// <summary>
+    /// The time (in seconds, see Platform.TimeSeconds) when the sample was taken.
+    /// </summary>
+    API_FIELD() float Time = 0.0f;
+
+    /// <summary>
+    /// The current ping (in milliseconds).
+    /// </summary>
+    API_FIELD() int32 Ping = 0;
+
+    /// <summary>
+    /// The fraction of the packets that were not lost or received out of order, measured locally (0-1). Negative value if not yet known.
+    /// </summary>
+    API_FIELD() float QualityLocal = 0.0f;
+
+    /// <summary>
+    /// The fraction of the packets that were not lost or received out of order, measured by the remote host (0-1). Negative value if not yet known.
+    /// </summary>
+    API_FIELD() float QualityRemote = 0.0f;
+
+    /// <summary>
+    /// The current outgoing data rate (in bytes per second).
+    /// </summary>
+    API_FIELD() float OutBytesPerSec = 0.0f;
+
+    /// <summary>
+    /// The current incoming data rate (in bytes per second).
+    /// </summary>
+    API_FIELD() float InBytesPerSec = 0.0f;
+
+    /// <summary>
+    /// The estimated rate at which data can be sent (in bytes per second).
+    /// </summary>
+    API_FIELD() int32 SendRate = 0;
+
+    /// <summary>
+    /// The amount of bytes of messages waiting to be sent (unreliable and reliable).
+    /// </summary>
+    API_FIELD() int32 PendingBytes = 0;
+
+    /// <summary>
+    /// The amount of bytes of reliable messages sent but not yet acknowledged.
+    /// </summary>
+    API_FIELD() int32 SentUnackedReliable = 0;
+
+    /// <summary>
+    /// The estimated time (in milliseconds) that a message sent now would wait in the queue before being sent.
+    /// </summary>
+    API_FIELD() float QueueTime = 0.0f;
+};
+
+/// <summary>
+/// The statistics of the Steam network connection lane compression (see SteamNetworkLane.Compression).
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkCompressionStats
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkCompressionStats);
+
+    /// <summary>
+    /// The amount of sent messages that got compressed.
+    /// </summary>
+    API_FIELD() int32 MessagesCompressed = 0;
+
+    /// <summary>
+    /// The amount of sent messages that were sent raw (below the threshold or not compressible).
+    /// </summary>
+    API_FIELD() int32 MessagesRaw = 0;
+
+    /// <summary>
+    /// The amount of received messages that got decompressed.
+    /// </summary>
+    API_FIELD() int32 MessagesDecompressed = 0;
+
+    /// <summary>
+    /// The total size (in bytes) of the sent messages before compression.
+    /// </summary>
+    API_FIELD() int64 BytesIn = 0;
+
+    /// <summary>
+    /// The total size (in bytes) of the sent messages after compression (including headers).
+    /// </summary>
+    API_FIELD() int64 BytesOut = 0;
+
+    /// <summary>
+    /// The total time (in milliseconds) spent on compression.
+    /// </summary>
+    API_FIELD() float CompressTime = 0.0f;
+
+    /// <summary>
+    /// The total time (in milliseconds) spent on decompression.
+    /// </summary>
+    API_FIELD() float DecompressTime = 0.0f;
+};
+
+/// <summary>
+/// The status of the Steam network connection send rate (see SteamNetworkSendRate).
+/// </summary>
+API_STRUCT(Namespace="FlaxEngine.Online.Steam") struct ONLINEPLATFORMSTEAM_API SteamNetworkSendRateStatus
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(SteamNetworkSendRateStatus);
+
+    /// <summary>
+    /// True if the send rate is controlled automatically.
+    /// </summary>
+    API_FIELD() bool Adaptive = false;
+
+    /// <summary>
+    /// The send rate (in bytes per second) set by the adaptive controller. 0 if not adaptive.
+    /// </summary>
+    API_FIELD() int32 SendRate = 0;
+
+    /// <summary>
+    /// The queue time (in milliseconds) used by the last adaptive controller decision.
+    /// </summary>
+    API_FIELD() float QueueTime = 0.0f;
+
+    /// <summary>
+    /// The amount of times the adaptive controller raised the send rate.
+    /// </summary>
+    API_FIELD() int32 Increases = 0;
+
+    /// <summary>
+    /// The amount of times the adaptive controller lowered the send rate.
+    /// </summary>
+    API_FIELD() int32 Decreases = 0;
+};
+
+/// <summary>
+/// Network driver implementation for Steam Networking Sockets. Uses peer-to-peer connections (identified by SteamID) that go through Steam Datagram Relay with NAT traversal and without exposing IP addresses. Requires Steam online platform to be initialized.
+/// </summary>
+/// <remarks>In loopback mode (see SteamSettings.NetworkLoopback) server and clients connect within the same process without Steam (used for testing). Sent messages are queued and submitted to Steam once per frame (on late update). Received messages are not copied: network messages point directly to the Steam buffers which stay valid until the end of the frame (released on late update), so received messages should not be kept for later frames. Optionally, polling and sending runs on a dedicated network thread (see SteamSettings.NetworkThread). NetworkConfig.Port is used as Steam P2P virtual port (not related to UDP ports). Client connects to the server SteamID given in NetworkConfig.Address.</remarks>
+API_CLASS(Sealed, Namespace="FlaxEngine.Online.Steam") class ONLINEPLATFORMSTEAM_API SteamNetworkDriver : public ScriptingObject, public INetworkDriver
+{
+    DECLARE_SCRIPTING_TYPE(SteamNetworkDriver);
+    friend class SteamNetworkDriverThread;
+    friend class SteamSignalingRecvContext;
+private:
+    // Maximum amount of messages received from Steam at once
+    static constexpr int32 MaxReceivedMessages = 256;
+
+    // Amount of connection lanes (one per network channel type)
+    static constexpr int32 LanesCount = 4;
+
+    // Connected peer (its index is stored as Steam connection user data to route received messages)
+    struct Peer
+    {
+        uint32 Connection = 0;
+        uint32 TotalDataReceived = 0;
+        Array<SteamNetworkConnectionStats> StatsHistory;
+        int32 StatsHistoryStart = 0;
+        SteamNetworkSendRate SendRate;
+        SteamNetworkSendRateStatus SendRateStatus;
+    };
+
+    // Connection closed by the remote peer or by the problem (closed once the messages received before are drained)
+    struct PendingClose
+    {
+        uint32 Connection;
+        NetworkEventType EventType;
+    };
+
+    NetworkConfig _config;
+    NetworkPeer* _networkHost = nullptr;
+    ISteamNetworkingSockets* _sockets = nullptr;
+    ISteamNetworkingUtils* _utils = nullptr;
+    uint32 _listenSocket = 0;
+    uint32 _pollGroup = 0;
+    uint32 _connection = 0;
+    Array<uint32> _connections;
+    Array<Peer> _peers;
+    int32 _lanePriorities[LanesCount];
+    uint16 _laneWeights[LanesCount];
+    int32 _laneCompression[LanesCount];
+    CriticalSection _compressionLocker;
+    SteamNetworkCompressionStats _compressionStats[LanesCount];
+    Array<byte> _compressionDictionary;
+    uint32 _compressionDictionaryId = 0;
+    void* _compressionDictionaryStream = nullptr;
+    void* _compressionStream = nullptr;
+    Array<byte> _compressionCapture;
+    int32 _compressionCaptureSize = 0;
+    Array<NetworkEvent> _events;
+    int32 _eventIndex = 0;
+    Array<NetworkEvent> _closeEvents;
+    int32 _closeEventIndex = 0;
+    Array<PendingClose> _pendingCloses;
+    Array<uint32> _inboxClosedConnections;
+    Array<uint32> _closedConnections;
+    Array<SteamNetworkingMessage_t*> _messages;
+    int32 _messageIndex = 0;
+    Array<SteamNetworkingMessage_t*> _receivedMessages;
+    Array<SteamNetworkingMessage_t*> _outbox;
+    Array<int64> _outboxResults;
+    Array<int32> _outboxSizes;
+    CriticalSection _locker;
+    CriticalSection _outboxLocker;
+    class SteamNetworkDriverThread* _thread = nullptr;
+    Array<NetworkEvent> _inboxEvents;
+    Array<SteamNetworkingMessage_t*> _inboxMessages;
+    volatile int64 _flushRequested = 0;
+    Array<uint32> _signaledConnections;
+    Array<byte> _signal;
+    double _connectTime = 0.0;
+    SteamNetworkLoopback* _loopback = nullptr;
+    Array<SteamNetworkLoopback::Message> _loopbackMessages;
+    Array<byte> _loopbackData;
+    volatile int64 _totalDataSent = 0;
+    uint32 _totalDataReceived = 0;
+    float _statsInterval = 0.0f;
+    int32 _statsHistorySize = 0;
+    double _statsLastTime = 0.0;
+    double _sendRateLastTime = 0.0;
+    SteamNetworkSendRate _sendRate;
+
+public:
+    // [INetworkDriver]
+    String DriverName() const override
+    {
+        return String("SteamNetworkDriver");
+    }
+    bool Initialize(NetworkPeer* host, const NetworkConfig& config) override;
+    void Dispose() override;
+    bool Listen() override;
+    bool Connect() override;
+    void Disconnect() override;
+    void Disconnect(const NetworkConnection& connection) override;
+    bool PopEvent(NetworkEvent& eventPtr) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, NetworkConnection target) override;
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, const Array<NetworkConnection, HeapAllocation>& targets) override;
+    NetworkDriverStats GetStats() override;
+    NetworkDriverStats GetStats(NetworkConnection target) override;
+
+public:
+    /// <summary>
+    /// Gets the real-time status of the connection lane used by the given network channel. Can be used to verify that the traffic on a channel doesn't delay the other channels.
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="channelType">The network channel type.</param>
+    /// <param name="status">The result lane status.</param>
+    /// <returns>True if failed to get the status (eg. invalid connection), otherwise false.</returns>
+    API_FUNCTION() bool GetLaneStatus(const NetworkConnection& connection, NetworkChannelType channelType, API_PARAM(Out) SteamNetworkLaneStatus& status);
+
+    /// <summary>
+    /// Gets the latest sample of the connection real-time statistics (sampled periodically, see SteamSettings.NetworkStatsInterval).
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="stats">The result statistics.</param>
+    /// <returns>True if failed to get the statistics (eg. invalid connection or no samples yet), otherwise false.</returns>
+    API_FUNCTION() bool GetConnectionStats(const NetworkConnection& connection, API_PARAM(Out) SteamNetworkConnectionStats& stats);
+
+    /// <summary>
+    /// Gets the history of the connection real-time statistics samples from the last seconds (see SteamSettings.NetworkStatsHistory). Samples are ordered from the oldest to the newest.
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="history">The result statistics samples.</param>
+    /// <returns>True if failed to get the statistics (eg. invalid connection), otherwise false.</returns>
+    API_FUNCTION() bool GetConnectionStatsHistory(const NetworkConnection& connection, API_PARAM(Out) Array<SteamNetworkConnectionStats>& history);
+
+    /// <summary>
+    /// Gets the detailed connection status text from Steam (useful for logging).
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <returns>The status text or empty string if connection is invalid.</returns>
+    API_FUNCTION() String GetConnectionDetailedStatus(const NetworkConnection& connection);
+
+    /// <summary>
+    /// Sets the network impairment simulation applied to all Steam connections (including the ones created later). Use default profile to disable impairment.
+    /// </summary>
+    /// <param name="impairment">The impairment profile (Enabled flag is ignored).</param>
+    /// <returns>True if failed to apply the impairment, otherwise false.</returns>
+    API_FUNCTION() static bool SetImpairment(const SteamNetworkImpairment& impairment);
+
+    /// <summary>
+    /// Sets the network impairment simulation applied to the given connection only (overrides the global impairment).
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="impairment">The impairment profile (Enabled flag is ignored).</param>
+    /// <returns>True if failed to apply the impairment (eg. invalid connection), otherwise false.</returns>
+    API_FUNCTION() bool SetConnectionImpairment(const NetworkConnection& connection, const SteamNetworkImpairment& impairment);
+
+    /// <summary>
+    /// Sets the send rate and Nagle policy of the given connection (overrides SteamSettings.NetworkSendRate).
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="sendRate">The send rate policy.</param>
+    /// <returns>True if failed to apply the policy (eg. invalid connection), otherwise false.</returns>
+    API_FUNCTION() bool SetConnectionSendRate(const NetworkConnection& connection, const SteamNetworkSendRate& sendRate);
+
+    /// <summary>
+    /// Gets the status of the connection send rate (including the adaptive controller decisions).
+    /// </summary>
+    /// <param name="connection">The connection.</param>
+    /// <param name="status">The result status.</param>
+    /// <returns>True if failed to get the status (eg. invalid connection), otherwise false.</returns>
+    API_FUNCTION() bool GetSendRateStatus(const NetworkConnection& connection, API_PARAM(Out) SteamNetworkSendRateStatus& status);
+
+    /// <summary>
+    /// Gets the compression statistics of the connection lane used by the given network channel (for all connections).
+    /// </summary>
+    /// <param name="channelType">The network channel type.</param>
+    /// <param name="stats">The result statistics.</param>
+    /// <returns>True if failed to get the statistics (eg. compression is disabled for the channel), otherwise false.</returns>
+    API_FUNCTION() bool GetCompressionStats(NetworkChannelType channelType, API_PARAM(Out) SteamNetworkCompressionStats& stats);
+
+    /// <summary>
+    /// Starts capturing the sent messages (on the lanes with compression enabled) to build the compression dictionary from the real traffic (see BuildCompressionDictionary).
+    /// </summary>
+    /// <param name="size">The maximum size (in bytes) of the captured data.</param>
+    API_FUNCTION() void CaptureCompressionSamples(int32 size = 1048576);
+
+    /// <summary>
+    /// Builds the compression dictionary from the captured messages and stops capturing. The dictionary can be saved with the game and set on all peers with SetCompressionDictionary.
+    /// </summary>
+    /// <param name="dictionary">The output dictionary.</param>
+    /// <returns>True if failed to build the dictionary (eg. nothing was captured), otherwise false.</returns>
+    API_FUNCTION() bool BuildCompressionDictionary(API_PARAM(Out) Array<byte>& dictionary);
+
+    /// <summary>
+    /// Sets the compression dictionary used by all Steam network drivers (including the ones created later). Dictionary improves compression of small messages. All peers need to use the same dictionary (messages compressed with a different one are rejected). Has to be called on a main thread.
+    /// </summary>
+    /// <param name="dictionary">The dictionary data (up to 64 kB, the end is used if it's bigger). Use empty to disable dictionary.</param>
+    API_FUNCTION() static void SetCompressionDictionary(const Array<byte>& dictionary);
+
+    /// <summary>
+    /// Sets the custom signaling backend used to negotiate P2P connections (instead of Steam signaling service). Applies to the connections created after the call. The driver adds the reference to the backend (released when replaced or unset with null) and so do the connections negotiated through it, so the caller can release its own reference at any time.
+    /// </summary>
+    /// <param name="signaling">The signaling backend or null to use Steam signaling.</param>
+    static void SetSignaling(SteamNetworkSignaling* signaling);
+
+private:
+    bool IsServer() const
+    {
+        return _listenSocket != 0;
+    }
+
+    bool HasConnection(uint32 connection) const;
+    void AddPeer(uint32 connection);
+    Peer* GetPeer(uint32 connection);
+    void CloseConnection(uint32 connection, bool linger);
+    void LoadCompressionDictionary();
+    int32 Encode(int32 lane, const NetworkMessage& message, byte* data);
+    bool Decode(const SteamNetworkingMessage_t* steamMessage, NetworkMessage& message);
+    void Send(const NetworkConnection* targets, int32 targetsCount, NetworkChannelType channelType, const NetworkMessage& message);
+    void OnLateUpdate();
+    void Flush();
+    void SampleStats();
+    bool ApplySendRate(Peer& peer);
+    void UpdateSendRates();
+    void UpdateSendRate(Peer& peer, float queueTime);
+    void SubmitOutbox();
+    void Poll();
+    bool Receive();
+    void ClosePendingConnections();
+    void ReleaseMessages(bool all);
+    void ReceiveSignals();
+    bool PopLoopbackEvent(NetworkEvent& eventPtr);
+    static void OnConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t* data);
+    void ConnectionStatusChanged(SteamNetConnectionStatusChangedCallback_t* data);
+};
+
+#endif
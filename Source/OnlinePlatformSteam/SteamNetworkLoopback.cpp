@@ -0,0 +1,118 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamNetworkLoopback.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Threading/Threading.h"
+
+namespace
+{
+    struct Link
+    {
+        SteamNetworkLoopback* Owner;
+        uint32 Remote;
+    };
+
+    // In-process network state (guarded by the locker, endpoint locks are taken after it)
+    CriticalSection Locker;
+    Dictionary<uint16, SteamNetworkLoopback*> Listeners;
+    Dictionary<uint32, Link> Links;
+    uint32 NextConnectionId = 1;
+}
+
+SteamNetworkLoopback::~SteamNetworkLoopback()
+{
+    ScopeLock lock(Locker);
+    if (_isListening)
+        Listeners.Remove(_port);
+    while (_connections.HasItems())
+        Disconnect(_connections.Last());
+}
+
+bool SteamNetworkLoopback::Listen(uint16 port, int32 connectionsLimit)
+{
+    ScopeLock lock(Locker);
+    if (_isListening || Listeners.ContainsKey(port))
+        return true;
+    Listeners.Add(port, this);
+    _port = port;
+    _connectionsLimit = connectionsLimit;
+    _isListening = true;
+    return false;
+}
+
+uint32 SteamNetworkLoopback::Connect(uint16 port)
+{
+    ScopeLock lock(Locker);
+    SteamNetworkLoopback* listener;
+    if (!Listeners.TryGet(port, listener) || listener == this || listener->_connections.Count() >= listener->_connectionsLimit)
+        return 0;
+    const uint32 local = NextConnectionId++;
+    const uint32 remote = NextConnectionId++;
+    Links.Add(local, { this, remote });
+    Links.Add(remote, { listener, local });
+    _connections.Add(local);
+    listener->_connections.Add(remote);
+    PushEvent(NetworkEventType::Connected, local);
+    listener->PushEvent(NetworkEventType::Connected, remote);
+    return local;
+}
+
+void SteamNetworkLoopback::Disconnect(uint32 connection)
+{
+    ScopeLock lock(Locker);
+    Link link;
+    if (!Links.TryGet(connection, link) || link.Owner != this)
+        return;
+    Link remoteLink;
+    if (Links.TryGet(link.Remote, remoteLink))
+    {
+        remoteLink.Owner->_connections.Remove(link.Remote);
+        remoteLink.Owner->PushEvent(NetworkEventType::Disconnected, link.Remote);
+        Links.Remove(link.Remote);
+    }
+    _connections.Remove(connection);
+    Links.Remove(connection);
+}
+
+bool SteamNetworkLoopback::Send(uint32 connection, const byte* data, int32 length)
+{
+    ScopeLock lock(Locker);
+    Link link, remoteLink;
+    if (!Links.TryGet(connection, link) || link.Owner != this || !Links.TryGet(link.Remote, remoteLink))
+        return true;
+    SteamNetworkLoopback* remote = remoteLink.Owner;
+    ScopeLock remoteLock(remote->_locker);
+    auto& message = remote->_messages.AddOne();
+    message.EventType = NetworkEventType::Message;
+    message.Connection = link.Remote;
+    message.Offset = remote->_data.Count();
+    message.Length = length;
+    remote->_data.Add(data, length);
+    return false;
+}
+
+void SteamNetworkLoopback::Pop(Array<Message>& messages, Array<byte>& data)
+{
+    ScopeLock lock(_locker);
+    const int32 dataOffset = data.Count();
+    for (Message& message : _messages)
+        message.Offset += dataOffset;
+    messages.Add(_messages);
+    _messages.Clear();
+    data.Add(_data);
+    _data.Clear();
+}
+
+void SteamNetworkLoopback::PushEvent(NetworkEventType eventType, uint32 connection)
+{
+    ScopeLock lock(_locker);
+    auto& message = _messages.AddOne();
+    message.EventType = eventType;
+    message.Connection = connection;
+    message.Offset = _data.Count();
+    message.Length = 0;
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Networking/NetworkEvent.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Platform/CriticalSection.h"
+
+/// <summary>
+/// In-process loopback endpoint used by Steam network driver in loopback mode. Endpoints in the same process connect to each other by port (like a socket pair) without Steam and without network. Connection events and messages are delivered in a single queue in the order they were sent, on the next poll.
+/// </summary>
+/// <remarks>
+/// Unlike Steam socket pairs, every message is delivered reliably and in order regardless of the channel type, and lanes (priorities and weights) are not modeled. Use real connections (or Steam network simulation settings) to test packet loss and lane scheduling.
+/// </remarks>
+class SteamNetworkLoopback
+{
+public:
+    struct Message
+    {
+        // Connected/Disconnected for connection events (no data) or Message for data messages.
+        NetworkEventType EventType;
+        uint32 Connection;
+        int32 Offset;
+        int32 Length;
+    };
+
+private:
+    CriticalSection _locker;
+    uint16 _port = 0;
+    int32 _connectionsLimit = 0;
+    bool _isListening = false;
+    Array<uint32> _connections;
+    Array<Message> _messages;
+    Array<byte> _data;
+
+public:
+    ~SteamNetworkLoopback();
+
+public:
+    /// <summary>
+    /// Starts accepting connections on the given port.
+    /// </summary>
+    /// <returns>True if failed (eg. port is already used), otherwise false.</returns>
+    bool Listen(uint16 port, int32 connectionsLimit);
+
+    /// <summary>
+    /// Connects to the endpoint listening on the given port. Both endpoints receive the connected event on the next poll.
+    /// </summary>
+    /// <returns>The connection identifier or 0 if failed.</returns>
+    uint32 Connect(uint16 port);
+
+    /// <summary>
+    /// Closes the connection. The remote endpoint receives the disconnected event on the next poll.
+    /// </summary>
+    void Disconnect(uint32 connection);
+
+    /// <summary>
+    /// Sends the message (copies the data) to the remote endpoint of the connection.
+    /// </summary>
+    /// <returns>True if failed (eg. connection is closed), otherwise false.</returns>
+    bool Send(uint32 connection, const byte* data, int32 length);
+
+    /// <summary>
+    /// Moves the received connection events and messages into the given list (appends them, preserving the order). Messages data is located in the data buffer (at message offset).
+    /// </summary>
+    void Pop(Array<Message>& messages, Array<byte>& data);
+
+private:
+    void PushEvent(NetworkEventType eventType, uint32 connection);
+};
+
+#endif
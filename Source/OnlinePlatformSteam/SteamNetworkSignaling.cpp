@@ -0,0 +1,278 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamNetworkSignaling.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Platform/Thread.h"
+#include "Engine/Threading/Threading.h"
+
+namespace
+{
+    // Frame header: data size (SteamID + signal) and SteamID
+    constexpr int32 FrameHeaderSize = sizeof(uint32) + sizeof(uint64);
+
+    // Limit for the signal size (Steam signals are small, bigger frames are treated as corrupted stream)
+    constexpr int32 MaxSignalSize = 64 * 1024;
+
+    bool WriteFrame(NetworkSocket& socket, uint64 steamId, const byte* data, int32 length)
+    {
+        Array<byte, InlinedAllocation<512>> frame;
+        frame.Resize(FrameHeaderSize + length);
+        const uint32 size = sizeof(uint64) + length;
+        Platform::MemoryCopy(frame.Get(), &size, sizeof(size));
+        Platform::MemoryCopy(frame.Get() + sizeof(uint32), &steamId, sizeof(steamId));
+        if (length)
+            Platform::MemoryCopy(frame.Get() + FrameHeaderSize, data, length);
+        return Network::WriteSocket(socket, frame.Get(), frame.Count()) != frame.Count();
+    }
+
+    // Reads all available data from the socket. Returns true if connection got closed or failed.
+    bool ReadSocket(NetworkSocket& socket, Array<byte>& buffer)
+    {
+        byte chunk[4096];
+        while (Network::IsReadable(socket))
+        {
+            const int32 read = Network::ReadSocket(socket, chunk, sizeof(chunk));
+            if (read <= 0)
+                return true;
+            buffer.Add(chunk, read);
+        }
+        return false;
+    }
+
+    // Reads all available data from the socket into the buffer (consumed data before the read offset is discarded first). Returns true if connection got closed or failed.
+    bool ReadSocket(NetworkSocket& socket, Array<byte>& buffer, int32& offset)
+    {
+        if (offset != 0)
+        {
+            const int32 remaining = buffer.Count() - offset;
+            if (remaining != 0)
+                Platform::MemoryCopy(buffer.Get(), buffer.Get() + offset, remaining);
+            buffer.Resize(remaining, false);
+            offset = 0;
+        }
+        return ReadSocket(socket, buffer);
+    }
+
+    // Pops the complete frame from the buffer (at the read offset, advanced past the frame). Returns true if frame was popped.
+    bool PopFrame(const Array<byte>& buffer, int32& offset, uint64& steamId, Array<byte>& data, bool& corrupted)
+    {
+        const int32 available = buffer.Count() - offset;
+        if (available < FrameHeaderSize)
+            return false;
+        const byte* frame = buffer.Get() + offset;
+        uint32 size;
+        Platform::MemoryCopy(&size, frame, sizeof(size));
+        if (size < sizeof(uint64) || size > sizeof(uint64) + MaxSignalSize)
+        {
+            corrupted = true;
+            return false;
+        }
+        const int32 frameSize = sizeof(uint32) + (int32)size;
+        if (available < frameSize)
+            return false;
+        Platform::MemoryCopy(&steamId, frame + sizeof(uint32), sizeof(steamId));
+        data.Set(frame + FrameHeaderSize, frameSize - FrameHeaderSize);
+        offset += frameSize;
+        return true;
+    }
+}
+
+void SteamNetworkSignaling::AddRef()
+{
+    Platform::InterlockedIncrement(&_refCount);
+}
+
+void SteamNetworkSignaling::Release()
+{
+    if (Platform::InterlockedDecrement(&_refCount) == 0)
+        Delete(this);
+}
+
+SteamTcpSignaling::~SteamTcpSignaling()
+{
+    Disconnect();
+}
+
+bool SteamTcpSignaling::Connect(const String& address, uint16 port, uint64 steamId)
+{
+    ScopeLock lock(_locker);
+    if (_isConnected)
+        return true;
+    NetworkEndPoint endPoint;
+    if (Network::CreateEndPoint(address, StringUtils::ToString((int32)port), NetworkIPVersion::IPv4, endPoint, false))
+    {
+        LOG(Error, "Invalid signaling server address '{0}:{1}'", address, port);
+        return true;
+    }
+    if (Network::CreateSocket(_socket, NetworkProtocol::Tcp, NetworkIPVersion::IPv4))
+        return true;
+    if (Network::ConnectSocket(_socket, endPoint))
+    {
+        LOG(Error, "Failed to connect to signaling server '{0}:{1}'", address, port);
+        Network::DestroySocket(_socket);
+        return true;
+    }
+    Network::SetSocketOption(_socket, NetworkSocketOption::NoDelay, true);
+    _isConnected = true;
+
+    // Register the local user (frame without signal data)
+    if (WriteFrame(_socket, steamId, nullptr, 0))
+    {
+        Disconnect();
+        return true;
+    }
+    LOG(Info, "Connected to signaling server '{0}:{1}'", address, port);
+    return false;
+}
+
+void SteamTcpSignaling::Disconnect()
+{
+    ScopeLock lock(_locker);
+    if (!_isConnected)
+        return;
+    Network::DestroySocket(_socket);
+    _isConnected = false;
+    _buffer.Clear();
+    _bufferOffset = 0;
+}
+
+bool SteamTcpSignaling::SendSignal(uint64 steamId, const byte* data, int32 length)
+{
+    ScopeLock lock(_locker);
+    return !_isConnected || WriteFrame(_socket, steamId, data, length);
+}
+
+bool SteamTcpSignaling::PopSignal(Array<byte>& data)
+{
+    ScopeLock lock(_locker);
+    if (!_isConnected)
+        return false;
+    uint64 steamId;
+    bool corrupted = false;
+    if (PopFrame(_buffer, _bufferOffset, steamId, data, corrupted))
+        return true;
+    bool closed = false;
+    if (!corrupted)
+    {
+        // Read more data only once all buffered frames were popped
+        closed = ReadSocket(_socket, _buffer, _bufferOffset);
+        if (PopFrame(_buffer, _bufferOffset, steamId, data, corrupted))
+            return true;
+    }
+    if (closed || corrupted)
+    {
+        LOG(Warning, "Lost connection to signaling server");
+        Disconnect();
+    }
+    return false;
+}
+
+SteamTcpSignalingServer::~SteamTcpSignalingServer()
+{
+    Shutdown();
+}
+
+bool SteamTcpSignalingServer::Start(uint16 port)
+{
+    ASSERT(!_thread);
+    NetworkEndPoint endPoint;
+    if (Network::CreateEndPoint(String::Empty, StringUtils::ToString((int32)port), NetworkIPVersion::IPv4, endPoint, true))
+        return true;
+    if (Network::CreateSocket(_socket, NetworkProtocol::Tcp, NetworkIPVersion::IPv4))
+        return true;
+    if (Network::BindSocket(_socket, endPoint) || Network::Listen(_socket, 64))
+    {
+        LOG(Error, "Failed to start signaling server on port {0}", port);
+        Network::DestroySocket(_socket);
+        return true;
+    }
+    _exitRequested = 0;
+    _thread = Thread::Create(this, TEXT("Steam Signaling Server"), ThreadPriority::BelowNormal);
+    if (!_thread)
+    {
+        Network::DestroySocket(_socket);
+        return true;
+    }
+    LOG(Info, "Started signaling server on port {0}", port);
+    return false;
+}
+
+void SteamTcpSignalingServer::Shutdown()
+{
+    if (!_thread)
+        return;
+    Stop();
+    _thread->Join();
+    Delete(_thread);
+    _thread = nullptr;
+    for (Client& client : _clients)
+        Network::DestroySocket(client.Socket);
+    _clients.Clear();
+    Network::DestroySocket(_socket);
+}
+
+int32 SteamTcpSignalingServer::Run()
+{
+    Array<byte> data;
+    while (Platform::AtomicRead(&_exitRequested) == 0)
+    {
+        // Accept new clients
+        while (Network::IsReadable(_socket))
+        {
+            auto& client = _clients.AddOne();
+            NetworkEndPoint endPoint;
+            if (Network::Accept(_socket, client.Socket, endPoint))
+            {
+                _clients.RemoveLast();
+                break;
+            }
+            Network::SetSocketOption(client.Socket, NetworkSocketOption::NoDelay, true);
+        }
+
+        // Route signals
+        for (int32 i = _clients.Count() - 1; i >= 0; i--)
+        {
+            Client& client = _clients[i];
+            bool closed = ReadSocket(client.Socket, client.Buffer, client.BufferOffset);
+            uint64 steamId;
+            while (PopFrame(client.Buffer, client.BufferOffset, steamId, data, closed))
+            {
+                if (client.SteamId == 0)
+                    client.SteamId = steamId;
+                else
+                    Route(client, steamId, data.Get(), data.Count());
+            }
+            if (closed)
+            {
+                Network::DestroySocket(client.Socket);
+                _clients.RemoveAt(i);
+            }
+        }
+
+        Platform::Sleep(1);
+    }
+    return 0;
+}
+
+void SteamTcpSignalingServer::Stop()
+{
+    Platform::InterlockedExchange(&_exitRequested, 1);
+}
+
+void SteamTcpSignalingServer::Route(Client& sender, uint64 steamId, const byte* data, int32 length)
+{
+    for (Client& client : _clients)
+    {
+        if (client.SteamId == steamId)
+        {
+            WriteFrame(client.Socket, sender.SteamId, data, length);
+            return;
+        }
+    }
+    LOG(Warning, "Signaling server: unknown receiver {0} (from {1})", steamId, sender.SteamId);
+}
+
+#endif
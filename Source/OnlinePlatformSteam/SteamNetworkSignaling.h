@@ -0,0 +1,136 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Platform/Network.h"
+#include "Engine/Threading/IRunnable.h"
+
+class Thread;
+
+/// <summary>
+/// Custom signaling backend used by Steam network driver to negotiate P2P connections (instead of Steam signaling service). Signals are opaque data blobs routed by the backend to the peer with the given SteamID.
+/// </summary>
+/// <remarks>Use SteamNetworkDriver::SetSignaling to enable it. The backend is reference-counted (connections negotiated through it keep it alive): create it with New and call Release instead of deleting it.</remarks>
+class ONLINEPLATFORMSTEAM_API SteamNetworkSignaling
+{
+private:
+    volatile int64 _refCount = 1;
+
+public:
+    virtual ~SteamNetworkSignaling() = default;
+
+    /// <summary>
+    /// Adds the reference to the backend. Can be called from any thread.
+    /// </summary>
+    void AddRef();
+
+    /// <summary>
+    /// Removes the reference from the backend and deletes it once the last reference is removed. Can be called from any thread.
+    /// </summary>
+    void Release();
+
+    /// <summary>
+    /// Sends the signal to the peer. Can be called from any thread.
+    /// </summary>
+    /// <param name="steamId">The peer SteamID.</param>
+    /// <param name="data">The signal data.</param>
+    /// <param name="length">The signal data size (in bytes).</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    virtual bool SendSignal(uint64 steamId, const byte* data, int32 length) = 0;
+
+    /// <summary>
+    /// Pops the signal received from any peer.
+    /// </summary>
+    /// <param name="data">The signal data.</param>
+    /// <returns>True if signal was popped, otherwise false.</returns>
+    virtual bool PopSignal(Array<byte>& data) = 0;
+};
+
+/// <summary>
+/// Signaling backend that uses TCP connection to the signaling server (see SteamTcpSignalingServer). The frame is a 32-bit size followed by 64-bit SteamID (receiver when sending, sender when received) and the signal data.
+/// </summary>
+class ONLINEPLATFORMSTEAM_API SteamTcpSignaling : public SteamNetworkSignaling
+{
+private:
+    NetworkSocket _socket;
+    bool _isConnected = false;
+    CriticalSection _locker;
+    Array<byte> _buffer;
+    int32 _bufferOffset = 0;
+
+public:
+    ~SteamTcpSignaling();
+
+public:
+    /// <summary>
+    /// Connects to the signaling server and registers the local user.
+    /// </summary>
+    /// <param name="address">The server address.</param>
+    /// <param name="port">The server port.</param>
+    /// <param name="steamId">The local user SteamID.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Connect(const String& address, uint16 port, uint64 steamId);
+
+    /// <summary>
+    /// Disconnects from the signaling server.
+    /// </summary>
+    void Disconnect();
+
+public:
+    // [SteamNetworkSignaling]
+    bool SendSignal(uint64 steamId, const byte* data, int32 length) override;
+    bool PopSignal(Array<byte>& data) override;
+};
+
+/// <summary>
+/// Local stand-in signaling server that routes signals between the connected SteamTcpSignaling clients (by SteamID). Runs on its own thread. Intended for tests and development.
+/// </summary>
+class ONLINEPLATFORMSTEAM_API SteamTcpSignalingServer : public IRunnable
+{
+private:
+    struct Client
+    {
+        NetworkSocket Socket;
+        uint64 SteamId = 0;
+        Array<byte> Buffer;
+        int32 BufferOffset = 0;
+    };
+
+    NetworkSocket _socket;
+    Thread* _thread = nullptr;
+    Array<Client> _clients;
+    volatile int64 _exitRequested = 0;
+
+public:
+    ~SteamTcpSignalingServer();
+
+public:
+    /// <summary>
+    /// Starts the server on the given port.
+    /// </summary>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Start(uint16 port);
+
+    /// <summary>
+    /// Stops the server and disconnects all clients.
+    /// </summary>
+    void Shutdown();
+
+public:
+    // [IRunnable]
+    String ToString() const override
+    {
+        return TEXT("SteamTcpSignalingServer");
+    }
+    int32 Run() override;
+    void Stop() override;
+
+private:
+    void Route(Client& sender, uint64 steamId, const byte* data, int32 length);
+};
+
+#endif
@@ -0,0 +1,147 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamPersonaCache.h"
+#include "OnlinePlatformSteam.h"
+#include "SteamHelpers.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+
+SteamPersonaCache::SteamPersonaCache(ISteamFriends* steamFriends)
+    : _steamFriends(steamFriends)
+{
+}
+
+const Array<OnlineUser>& SteamPersonaCache::GetFriends()
+{
+    if (_isDirty)
+        Rebuild();
+    return _friends;
+}
+
+StringView SteamPersonaCache::GetName(uint64 steamId)
+{
+    if (_isDirty)
+        Rebuild();
+    int32 index;
+    if (_indices.TryGet(steamId, index))
+        return _friends[index].Name;
+    return StringView::Empty;
+}
+
+void SteamPersonaCache::Invalidate()
+{
+    if (!_isDirty)
+    {
+        _isDirty = true;
+        _version++;
+    }
+}
+
+void SteamPersonaCache::OnPersonaStateChange(uint64 steamId, int32 changeFlags)
+{
+    const CSteamID userId(steamId);
+    const bool isFriend = _steamFriends->HasFriend(userId, k_EFriendFlagImmediate);
+
+    // Indices of the dirty cache still describe the last built friends list (used to detect removed friends)
+    int32 index = -1;
+    _indices.TryGet(steamId, index);
+    if (!isFriend && index == -1)
+        return;
+
+    // Patch the cache
+    SteamFriendChanges changes = SteamFriendChanges::None;
+    if (changeFlags & k_EPersonaChangeRelationshipChanged)
+        changes |= isFriend ? SteamFriendChanges::Added : SteamFriendChanges::Removed;
+    if (changeFlags & (k_EPersonaChangeName | k_EPersonaChangeNickname))
+        changes |= SteamFriendChanges::Name;
+    if (changeFlags & (k_EPersonaChangeStatus | k_EPersonaChangeComeOnline | k_EPersonaChangeGoneOffline))
+        changes |= SteamFriendChanges::Presence;
+    if (changeFlags & k_EPersonaChangeGamePlayed)
+        changes |= SteamFriendChanges::GamePlayed;
+    if (!_isDirty)
+    {
+        if (index != -1 && !isFriend)
+        {
+            // Friend removed
+            _friends.RemoveAtKeepOrder(index);
+            _indices.Remove(steamId);
+            for (int32 i = index; i < _friends.Count(); i++)
+                _indices[GetSteamId(_friends[i].Id).ConvertToUint64()] = i;
+            _version++;
+        }
+        else if (index == -1 && isFriend)
+        {
+            // Friend added
+            _indices[steamId] = _friends.Count();
+            UpdateUser(_friends.AddOne(), steamId);
+            _version++;
+        }
+        else if (index != -1)
+        {
+            UpdateUser(_friends[index], steamId);
+            _version++;
+        }
+    }
+
+    // Collect changes (merged per user until the next PopChanges)
+    if (CollectChanges && changes != SteamFriendChanges::None)
+    {
+        SteamFriendChanges& pending = _pendingChanges[steamId];
+        if (EnumHasAnyFlags(changes, SteamFriendChanges::Added | SteamFriendChanges::Removed))
+            pending &= ~(SteamFriendChanges::Added | SteamFriendChanges::Removed);
+        pending |= changes;
+    }
+}
+
+void SteamPersonaCache::PopChanges(Array<SteamFriendChange>& changes)
+{
+    changes.Clear();
+    if (_pendingChanges.IsEmpty())
+        return;
+    PROFILE_CPU();
+    changes.Resize(_pendingChanges.Count());
+    int32 i = 0;
+    for (const auto& e : _pendingChanges)
+    {
+        auto& change = changes[i++];
+        change.Changes = e.Value;
+        if (EnumHasAnyFlags(e.Value, SteamFriendChanges::Removed))
+        {
+            change.User.Id = GetUserId(CSteamID(e.Key));
+            change.User.PresenceState = OnlinePresenceStates::Offline;
+        }
+        else
+        {
+            UpdateUser(change.User, e.Key);
+        }
+    }
+    _pendingChanges.Clear();
+}
+
+void SteamPersonaCache::Rebuild()
+{
+    PROFILE_CPU();
+    _isDirty = false;
+    const int32 friendsCount = _steamFriends->GetFriendCount(k_EFriendFlagImmediate);
+    _friends.Resize(Math::Max(friendsCount, 0));
+    _indices.Clear();
+    for (int32 i = 0; i < _friends.Count(); i++)
+    {
+        const CSteamID friendId = _steamFriends->GetFriendByIndex(i, k_EFriendFlagImmediate);
+        _indices[friendId.ConvertToUint64()] = i;
+        UpdateUser(_friends[i], friendId.ConvertToUint64());
+    }
+}
+
+void SteamPersonaCache::UpdateUser(OnlineUser& user, uint64 steamId) const
+{
+    const CSteamID friendId(steamId);
+    user.Id = GetUserId(friendId);
+    const char* name = _steamFriends->GetFriendPersonaName(friendId);
+    user.Name.SetUTF8(name, StringUtils::Length(name));
+    user.PresenceState = GetUserPresence(_steamFriends->GetFriendPersonaState(friendId));
+}
+
+#endif
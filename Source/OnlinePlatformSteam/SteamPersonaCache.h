@@ -0,0 +1,78 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Online/IOnlinePlatform.h"
+
+class ISteamFriends;
+struct SteamFriendChange;
+enum class SteamFriendChanges;
+
+/// <summary>
+/// Persistent cache of the local user friends (keyed by SteamID). Patched in place by PersonaStateChange_t callbacks so reading the friends list doesn't query Steam for every friend. Used only on a main thread.
+/// </summary>
+class SteamPersonaCache
+{
+private:
+    ISteamFriends* _steamFriends;
+    Array<OnlineUser> _friends;
+    Dictionary<uint64, int32> _indices;
+    Dictionary<uint64, SteamFriendChanges> _pendingChanges;
+    uint32 _version = 1;
+    bool _isDirty = true;
+
+public:
+    SteamPersonaCache(ISteamFriends* steamFriends);
+
+    /// <summary>
+    /// True if collect the friends list changes for PopChanges.
+    /// </summary>
+    bool CollectChanges = false;
+
+public:
+    /// <summary>
+    /// Gets the cache version. Incremented on every change to the friends list or any of the friends persona.
+    /// </summary>
+    FORCE_INLINE uint32 GetVersion() const
+    {
+        return _version;
+    }
+
+    /// <summary>
+    /// Gets the cached friends list (rebuilt if needed).
+    /// </summary>
+    const Array<OnlineUser>& GetFriends();
+
+    /// <summary>
+    /// Gets the cached persona name of the friend. Returned view is valid until the next cache change.
+    /// </summary>
+    /// <returns>The friend name or empty if user is not a friend.</returns>
+    StringView GetName(uint64 steamId);
+
+    /// <summary>
+    /// Marks the whole cache to be rebuilt on next access.
+    /// </summary>
+    void Invalidate();
+
+    /// <summary>
+    /// Updates the cached persona after the PersonaStateChange_t callback.
+    /// </summary>
+    /// <param name="steamId">The user SteamID.</param>
+    /// <param name="changeFlags">The EPersonaChange flags.</param>
+    void OnPersonaStateChange(uint64 steamId, int32 changeFlags);
+
+    /// <summary>
+    /// Gets the friends changes collected since the last call.
+    /// </summary>
+    void PopChanges(Array<SteamFriendChange>& changes);
+
+private:
+    void Rebuild();
+    void UpdateUser(OnlineUser& user, uint64 steamId) const;
+};
+
+#endif
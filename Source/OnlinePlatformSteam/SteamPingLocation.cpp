@@ -0,0 +1,96 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamPingLocation.h"
+#include "Engine/Core/Collections/Sorting.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Utilities/StringConverter.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+
+SteamPingLocationService::SteamPingLocationService(ISteamNetworkingUtils* utils)
+    : _utils(utils)
+{
+    Platform::MemoryClear(&_local, sizeof(_local));
+}
+
+bool SteamPingLocationService::GetLocal(String& location)
+{
+    SteamNetworkPingLocation_t local;
+    if (_utils->GetLocalPingLocation(local) < 0.0f)
+        return true;
+    if (_localString.IsEmpty() || Platform::MemoryCompare(&local, &_local, sizeof(local)) != 0)
+    {
+        // Location got measured again
+        char buffer[k_cchMaxSteamNetworkingPingLocationString];
+        _utils->ConvertPingLocationToString(local, buffer, ARRAY_COUNT(buffer));
+        _local = local;
+        _localString = String(buffer);
+    }
+    location = _localString;
+    return false;
+}
+
+int32 SteamPingLocationService::EstimatePing(const StringView& location)
+{
+    const Location& e = Parse(location);
+    if (!e.IsValid)
+        return -1;
+    const int32 ping = _utils->EstimatePingTimeFromLocalHost(e.Data);
+    return ping < 0 ? -1 : ping;
+}
+
+int32 SteamPingLocationService::EstimatePing(const StringView& locationA, const StringView& locationB)
+{
+    // Copy the first location (parsing the second one can modify the cache)
+    const Location a = Parse(locationA);
+    const Location& b = Parse(locationB);
+    if (!a.IsValid || !b.IsValid)
+        return -1;
+    const int32 ping = _utils->EstimatePingTimeBetweenTwoLocations(a.Data, b.Data);
+    return ping < 0 ? -1 : ping;
+}
+
+void SteamPingLocationService::EstimatePings(const Array<String>& locations, Array<int32>& pings)
+{
+    PROFILE_CPU();
+    pings.Resize(locations.Count(), false);
+    for (int32 i = 0; i < locations.Count(); i++)
+        pings[i] = EstimatePing(locations[i]);
+}
+
+void SteamPingLocationService::Rank(const Array<String>& locations, Array<int32>& ranking, Array<int32>& pings)
+{
+    EstimatePings(locations, pings);
+
+    // Sort by ping (high bits) and index (low bits), unknown pings go last
+    Array<int64> keys;
+    keys.Resize(pings.Count());
+    for (int32 i = 0; i < pings.Count(); i++)
+        keys[i] = ((int64)(pings[i] < 0 ? MAX_int32 : pings[i]) << 32) | (int64)i;
+    Sorting::QuickSort(keys.Get(), keys.Count());
+    ranking.Resize(keys.Count(), false);
+    for (int32 i = 0; i < keys.Count(); i++)
+        ranking[i] = (int32)(keys[i] & MAX_uint32);
+}
+
+const SteamPingLocationService::Location& SteamPingLocationService::Parse(const StringView& location)
+{
+    int32 index;
+    if (_indices.TryGet(location, index))
+        return _locations[index];
+    if (_locations.Count() >= MaxCachedLocations)
+    {
+        _indices.Clear();
+        _locations.Clear();
+    }
+    index = _locations.Count();
+    Location& e = _locations.AddOne();
+    const StringAsANSI<256> locationAnsi(location.Get(), location.Length());
+    e.IsValid = _utils->ParsePingLocationString(locationAnsi.Get(), e.Data);
+    _indices.Add(String(location), index);
+    return e;
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include <Steamworks/steamnetworkingtypes.h>
+
+class ISteamNetworkingUtils;
+
+/// <summary>
+/// Ping location service. Publishes the local ping location string (eg. to be stored in the lobby data) and estimates the round-trip time to the remote hosts from their ping location strings (parsed locations are cached). Used only on a main thread.
+/// </summary>
+class SteamPingLocationService
+{
+private:
+    struct Location
+    {
+        SteamNetworkPingLocation_t Data;
+        bool IsValid;
+    };
+
+    // Maximum amount of cached locations (cache gets cleared when exceeded)
+    static constexpr int32 MaxCachedLocations = 1024;
+
+    ISteamNetworkingUtils* _utils;
+    SteamNetworkPingLocation_t _local;
+    String _localString;
+    Dictionary<String, int32> _indices;
+    Array<Location> _locations;
+
+public:
+    SteamPingLocationService(ISteamNetworkingUtils* utils);
+
+public:
+    /// <summary>
+    /// Gets the local ping location string.
+    /// </summary>
+    /// <returns>True if location is not yet available (relay network is not ready), otherwise false.</returns>
+    bool GetLocal(String& location);
+
+    /// <summary>
+    /// Estimates the round-trip time (in milliseconds) from the local host to the given location.
+    /// </summary>
+    /// <returns>The estimated ping or -1 if unknown.</returns>
+    int32 EstimatePing(const StringView& location);
+
+    /// <summary>
+    /// Estimates the round-trip time (in milliseconds) between the two locations (eg. between two players).
+    /// </summary>
+    /// <returns>The estimated ping or -1 if unknown.</returns>
+    int32 EstimatePing(const StringView& locationA, const StringView& locationB);
+
+    /// <summary>
+    /// Estimates the round-trip times (in milliseconds) from the local host to the given locations (-1 if unknown).
+    /// </summary>
+    void EstimatePings(const Array<String>& locations, Array<int32>& pings);
+
+    /// <summary>
+    /// Sorts the candidate hosts by the estimated round-trip time from the local host. Hosts with unknown ping go last.
+    /// </summary>
+    /// <param name="locations">The hosts locations.</param>
+    /// <param name="ranking">The output indices of the hosts (in the locations list) from the best to the worst.</param>
+    /// <param name="pings">The output estimated pings of the hosts (in the locations list order).</param>
+    void Rank(const Array<String>& locations, Array<int32>& ranking, Array<int32>& pings);
+
+private:
+    const Location& Parse(const StringView& location);
+};
+
+#endif
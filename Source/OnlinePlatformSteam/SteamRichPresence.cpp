@@ -0,0 +1,173 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamRichPresence.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Utilities/StringConverter.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+
+SteamRichPresenceWriter::SteamRichPresenceWriter(ISteamFriends* steamFriends, float updateInterval)
+    : _steamFriends(steamFriends)
+    , _updateInterval(updateInterval)
+{
+}
+
+bool SteamRichPresenceWriter::Set(const StringView& key, const StringView& value)
+{
+    const StringAsANSI<k_cchMaxRichPresenceKeyLength> keyStr(key.Get(), key.Length());
+    if (keyStr.Length() == 0 || keyStr.Length() >= k_cchMaxRichPresenceKeyLength)
+    {
+        LOG(Warning, "Invalid Steam rich presence key '{0}'", key);
+        return true;
+    }
+    const StringAnsi keyAnsi(keyStr.Get(), keyStr.Length());
+    if (value.IsEmpty())
+    {
+        if (_pending.Remove(keyAnsi))
+            _isDirty = true;
+        return false;
+    }
+    const StringAsUTF8<k_cchMaxRichPresenceValueLength> valueStr(value.Get(), value.Length());
+    if (valueStr.Length() >= k_cchMaxRichPresenceValueLength)
+    {
+        LOG(Warning, "Too long Steam rich presence value for key '{0}'", key);
+        return true;
+    }
+    if (_pending.Count() >= k_cchMaxRichPresenceKeys && !_pending.ContainsKey(keyAnsi))
+    {
+        LOG(Warning, "Too many Steam rich presence keys (limit is {0}), cannot set key '{1}'", (int32)k_cchMaxRichPresenceKeys, key);
+        return true;
+    }
+    StringAnsi& pending = _pending[keyAnsi];
+    if (pending.Length() != valueStr.Length() || StringUtils::Compare(pending.Get(), valueStr.Get(), valueStr.Length()) != 0)
+    {
+        pending.Set(valueStr.Get(), valueStr.Length());
+        _isDirty = true;
+    }
+    return false;
+}
+
+void SteamRichPresenceWriter::Clear()
+{
+    if (_pending.HasItems())
+    {
+        _pending.Clear();
+        _isDirty = true;
+    }
+}
+
+void SteamRichPresenceWriter::Flush(bool force)
+{
+    if (!_isDirty)
+        return;
+    const double time = Platform::GetTimeSeconds();
+    if (!force && time - _lastFlushTime < _updateInterval)
+        return;
+    PROFILE_CPU();
+    _isDirty = false;
+    _lastFlushTime = time;
+
+    if (_pending.IsEmpty())
+    {
+        // Remove all keys at once
+        if (_committed.HasItems())
+        {
+            _steamFriends->ClearRichPresence();
+            _committed.Clear();
+        }
+        return;
+    }
+    // Remove keys that are no longer used
+    for (auto it = _committed.Begin(); it.IsNotEnd(); ++it)
+    {
+        if (!_pending.ContainsKey(it->Key))
+        {
+            _steamFriends->SetRichPresence(it->Key.Get(), nullptr);
+            _committed.Remove(it);
+        }
+    }
+
+    // Send modified keys
+    for (const auto& e : _pending)
+    {
+        const auto committed = _committed.Find(e.Key);
+        if (committed.IsNotEnd() && committed->Value == e.Value)
+            continue;
+        if (_steamFriends->SetRichPresence(e.Key.Get(), e.Value.Get()))
+            _committed[e.Key] = e.Value;
+        else
+            LOG(Warning, "Failed to set Steam rich presence key '{0}'", String(e.Key));
+    }
+}
+
+SteamRichPresenceCache::SteamRichPresenceCache(ISteamFriends* steamFriends)
+    : _steamFriends(steamFriends)
+{
+}
+
+int32 SteamRichPresenceCache::GetKeyId(const StringView& key)
+{
+    int32 id;
+    if (!_keyIds.TryGet(key, id))
+    {
+        id = _keyIds.Count();
+        _keyIds.Add(String(key), id);
+    }
+    return id;
+}
+
+StringView SteamRichPresenceCache::Get(uint64 steamId, int32 keyId)
+{
+    const Table& table = GetTable(steamId);
+    const int32 index = table.Keys.Find(keyId);
+    return index != -1 ? StringView(table.Values[index]) : StringView::Empty;
+}
+
+void SteamRichPresenceCache::Invalidate(uint64 steamId)
+{
+    auto it = _tables.Find(steamId);
+    if (it.IsNotEnd())
+        it->Value.IsValid = false;
+}
+
+void SteamRichPresenceCache::Clear()
+{
+    _tables.Clear();
+}
+
+SteamRichPresenceCache::Table& SteamRichPresenceCache::GetTable(uint64 steamId)
+{
+    Table& table = _tables[steamId];
+    if (table.IsValid)
+        return table;
+    PROFILE_CPU();
+
+    // Read the whole key/value table
+    const CSteamID userId(steamId);
+    const int32 count = _steamFriends->GetFriendRichPresenceKeyCount(userId);
+    table.Keys.Clear();
+    table.Values.Resize(Math::Max(count, 0));
+    for (int32 i = 0; i < count; i++)
+    {
+        const char* key = _steamFriends->GetFriendRichPresenceKeyByIndex(userId, i);
+        const char* value = _steamFriends->GetFriendRichPresence(userId, key);
+        table.Values[i].SetUTF8(value, StringUtils::Length(value));
+        table.Keys.Add(GetKeyId(String(key)));
+    }
+    table.IsValid = true;
+
+    // Request data from Steam if not yet available (FriendRichPresenceUpdate_t will invalidate the table once it arrives)
+    if (count <= 0 && !table.IsRequested)
+    {
+        table.IsRequested = true;
+        _steamFriends->RequestFriendRichPresence(userId);
+    }
+    return table;
+}
+
+#endif
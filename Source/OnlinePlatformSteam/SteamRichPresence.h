@@ -0,0 +1,95 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+
+class ISteamFriends;
+
+/// <summary>
+/// Local user rich presence writer. Keeps the table of the last committed key/value pairs and sends only the modified keys to Steam. Updates are coalesced within a time window to avoid Steam throttling. Used only on a main thread.
+/// </summary>
+class SteamRichPresenceWriter
+{
+private:
+    ISteamFriends* _steamFriends;
+    Dictionary<StringAnsi, StringAnsi> _committed;
+    Dictionary<StringAnsi, StringAnsi> _pending;
+    double _updateInterval;
+    double _lastFlushTime = -1000.0;
+    bool _isDirty = false;
+
+public:
+    SteamRichPresenceWriter(ISteamFriends* steamFriends, float updateInterval);
+
+public:
+    /// <summary>
+    /// Sets the rich presence value. Empty value removes the key.
+    /// </summary>
+    /// <returns>True if failed (eg. invalid key or value, or too many keys), otherwise false.</returns>
+    bool Set(const StringView& key, const StringView& value);
+
+    /// <summary>
+    /// Removes all rich presence keys.
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// Sends the modified keys to Steam if the update window elapsed (or if forced).
+    /// </summary>
+    void Flush(bool force = false);
+};
+
+/// <summary>
+/// Cache of the friends rich presence. Key/value tables are read from Steam once and kept until FriendRichPresenceUpdate_t invalidates them. Keys are interned so tables store only small key identifiers. Used only on a main thread.
+/// </summary>
+class SteamRichPresenceCache
+{
+private:
+    struct Table
+    {
+        Array<int32> Keys;
+        Array<String> Values;
+        bool IsValid = false;
+        bool IsRequested = false;
+    };
+
+    ISteamFriends* _steamFriends;
+    Dictionary<String, int32> _keyIds;
+    Dictionary<uint64, Table> _tables;
+
+public:
+    SteamRichPresenceCache(ISteamFriends* steamFriends);
+
+public:
+    /// <summary>
+    /// Gets the interned key identifier.
+    /// </summary>
+    int32 GetKeyId(const StringView& key);
+
+    /// <summary>
+    /// Gets the friend rich presence value. Returned view is valid until the friend table gets invalidated.
+    /// </summary>
+    /// <returns>The value or empty if key is not set.</returns>
+    StringView Get(uint64 steamId, int32 keyId);
+
+    /// <summary>
+    /// Marks the friend key/value table to be read again (eg. after FriendRichPresenceUpdate_t).
+    /// </summary>
+    void Invalidate(uint64 steamId);
+
+    /// <summary>
+    /// Removes all cached tables.
+    /// </summary>
+    void Clear();
+
+private:
+    Table& GetTable(uint64 steamId);
+};
+
+#endif
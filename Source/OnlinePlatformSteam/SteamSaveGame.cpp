@@ -0,0 +1,279 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "SteamSaveGame.h"
+#include "OnlinePlatformSteam.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Platform/Thread.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Utilities/StringConverter.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include <Steamworks/steam_api.h>
+#include <ThirdParty/LZ4/lz4.h>
+
+namespace
+{
+    // Header placed before the compressed savegame data
+    struct SaveGameHeader
+    {
+        static constexpr uint32 MagicCode = 0x315A5346; // 'FSZ1'
+        static constexpr byte CurrentVersion = 1;
+
+        // Upper limit for the decompressed savegame size (protects against corrupted or malicious headers)
+        static constexpr int32 MaxUncompressedSize = 256 * 1024 * 1024;
+
+        // Maximum LZ4 compression ratio
+        static constexpr int32 MaxCompressionRatio = 255;
+
+        uint32 Magic;
+        byte Version;
+        byte Padding[3];
+        int32 UncompressedSize;
+
+        bool IsValid(int32 compressedSize) const
+        {
+            return Magic == MagicCode &&
+                    Version == CurrentVersion &&
+                    UncompressedSize > 0 &&
+                    UncompressedSize <= MaxUncompressedSize &&
+                    (int64)UncompressedSize <= (int64)compressedSize * MaxCompressionRatio;
+        }
+    };
+}
+
+bool SteamSaveGame::Read(ISteamRemoteStorage* remoteStorage, const StringView& name, Array<byte>& data)
+{
+    PROFILE_CPU();
+    const StringAsANSI<> nameStr(name.Get(), name.Length());
+    data.Clear();
+    if (remoteStorage->FileExists(nameStr.Get()))
+    {
+        const int32 size = remoteStorage->GetFileSize(nameStr.Get());
+        if (size > 0)
+        {
+            Array<byte> fileData;
+            fileData.Resize(size);
+            const int32 read = remoteStorage->FileRead(nameStr.Get(), fileData.Get(), size);
+            if (read != size)
+                return true;
+
+            // Decompress data (savegames written without compression are stored raw)
+            const SaveGameHeader* header = (const SaveGameHeader*)fileData.Get();
+            const int32 compressedSize = size - (int32)sizeof(SaveGameHeader);
+            if (compressedSize > 0 && header->IsValid(compressedSize))
+            {
+                PROFILE_CPU_NAMED("Decompress");
+                data.Resize(header->UncompressedSize, false);
+                const int32 decompressedSize = LZ4_decompress_safe((const char*)(header + 1), (char*)data.Get(), compressedSize, data.Count());
+                if (decompressedSize != header->UncompressedSize)
+                {
+                    LOG(Error, "Failed to decompress Steam savegame '{0}' (corrupted data)", name);
+                    data.Clear();
+                    return true;
+                }
+                return false;
+            }
+            data = MoveTemp(fileData);
+        }
+    }
+    return false;
+}
+
+bool SteamSaveGame::Write(ISteamRemoteStorage* remoteStorage, const StringView& name, const Span<byte>& data, int32 compressionThreshold)
+{
+    PROFILE_CPU();
+    const StringAsANSI<> nameStr(name.Get(), name.Length());
+    if (data.Length() > 0)
+    {
+        if (compressionThreshold >= 0 && data.Length() >= compressionThreshold)
+        {
+            // Compress data (use it only if it's smaller than raw data)
+            PROFILE_CPU_NAMED("Compress");
+            Array<byte> fileData;
+            fileData.Resize(sizeof(SaveGameHeader) + LZ4_compressBound(data.Length()), false);
+            SaveGameHeader* header = (SaveGameHeader*)fileData.Get();
+            header->Magic = SaveGameHeader::MagicCode;
+            header->Version = SaveGameHeader::CurrentVersion;
+            Platform::MemoryClear(header->Padding, sizeof(header->Padding));
+            header->UncompressedSize = data.Length();
+            const int32 compressedSize = LZ4_compress_default((const char*)data.Get(), (char*)(header + 1), data.Length(), fileData.Count() - (int32)sizeof(SaveGameHeader));
+            const int32 fileSize = (int32)sizeof(SaveGameHeader) + compressedSize;
+            if (compressedSize > 0 && fileSize < data.Length())
+            {
+                // Write
+                return !remoteStorage->FileWrite(nameStr.Get(), fileData.Get(), fileSize);
+            }
+        }
+
+        // Write
+        return !remoteStorage->FileWrite(nameStr.Get(), data.Get(), data.Length());
+    }
+    else if (remoteStorage->FileExists(nameStr.Get()))
+    {
+        // Delete
+        return !remoteStorage->FileDelete(nameStr.Get());
+    }
+    return false;
+}
+
+SteamSaveGameWorker::SteamSaveGameWorker(ISteamRemoteStorage* remoteStorage, int32 compressionThreshold)
+    : _remoteStorage(remoteStorage)
+    , _compressionThreshold(compressionThreshold)
+{
+}
+
+SteamSaveGameWorker::~SteamSaveGameWorker()
+{
+    Shutdown();
+}
+
+bool SteamSaveGameWorker::Start()
+{
+    ASSERT(!_thread);
+    _exitRequested = false;
+    _thread = Thread::Create(this, TEXT("Steam Save Worker"), ThreadPriority::BelowNormal);
+    return _thread == nullptr;
+}
+
+void SteamSaveGameWorker::Shutdown()
+{
+    if (!_thread)
+        return;
+    Flush();
+    Stop();
+    _thread->Join();
+    Delete(_thread);
+    _thread = nullptr;
+}
+
+void SteamSaveGameWorker::Enqueue(const StringView& name, const Span<byte>& data)
+{
+    PROFILE_CPU();
+    ScopeLock lock(_locker);
+    Array<byte>& pending = _buffers[_backBuffer].Files[String(name)];
+    pending.Set(data.Get(), data.Length());
+    _workSignal.NotifyOne();
+}
+
+void SteamSaveGameWorker::EnqueueBatch(uint32 id, const Array<SteamSaveGameFile>& files)
+{
+    PROFILE_CPU();
+    ScopeLock lock(_locker);
+    auto& buffer = _buffers[_backBuffer];
+    auto& batch = buffer.Batches.AddOne();
+    batch.Id = id;
+    batch.Files.Resize(files.Count());
+    for (int32 i = 0; i < files.Count(); i++)
+    {
+        const SteamSaveGameFile& file = files[i];
+        batch.Files[i] = file.Name;
+        buffer.Files[file.Name] = file.Data;
+    }
+    _workSignal.NotifyOne();
+}
+
+void SteamSaveGameWorker::PopCompletedBatches(Array<BatchResult>& results)
+{
+    ScopeLock lock(_locker);
+    results.Add(_results);
+    _results.Clear();
+}
+
+bool SteamSaveGameWorker::TryGetPending(const StringView& name, Array<byte>& data)
+{
+    ScopeLock lock(_locker);
+    const String key(name);
+
+    // Back buffer holds the latest data, then check the one that is being written right now
+    for (int32 i = 0; i < 2; i++)
+    {
+        const auto& buffer = _buffers[(_backBuffer + i) % 2].Files;
+        const auto it = buffer.Find(key);
+        if (it.IsNotEnd())
+        {
+            data = it->Value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SteamSaveGameWorker::Flush()
+{
+    PROFILE_CPU();
+    ScopeLock lock(_locker);
+    while (_thread && (_isWriting || _buffers[_backBuffer].Files.Count() != 0))
+        _idleSignal.Wait(_locker);
+}
+
+int32 SteamSaveGameWorker::Run()
+{
+    Array<String> failedFiles;
+    Array<BatchResult> results;
+    while (true)
+    {
+        // Wait for work and swap buffers
+        int32 frontBuffer;
+        {
+            ScopeLock lock(_locker);
+            while (!_exitRequested && _buffers[_backBuffer].Files.Count() == 0)
+                _workSignal.Wait(_locker);
+            if (_buffers[_backBuffer].Files.Count() == 0)
+                break;
+            frontBuffer = _backBuffer;
+            _backBuffer = (_backBuffer + 1) % 2;
+            _isWriting = true;
+        }
+
+        // Write savegames (front buffer is not modified by the game thread)
+        auto& buffer = _buffers[frontBuffer];
+        const bool useBatch = buffer.Batches.HasItems();
+        if (useBatch)
+            _remoteStorage->BeginFileWriteBatch();
+        for (auto& e : buffer.Files)
+        {
+            if (SteamSaveGame::Write(_remoteStorage, e.Key, Span<byte>(e.Value.Get(), e.Value.Count()), _compressionThreshold))
+            {
+                LOG(Warning, "Failed to write Steam savegame '{0}'", e.Key);
+                failedFiles.Add(e.Key);
+            }
+        }
+        if (useBatch)
+            _remoteStorage->EndFileWriteBatch();
+
+        // Report batches completion (batch fails if any of its files failed to write)
+        for (const auto& batch : buffer.Batches)
+        {
+            auto& result = results.AddOne();
+            result.Id = batch.Id;
+            result.Failed = false;
+            for (const auto& file : batch.Files)
+                result.Failed |= failedFiles.Contains(file);
+        }
+        failedFiles.Clear();
+
+        {
+            ScopeLock lock(_locker);
+            _results.Add(results);
+            buffer.Files.Clear();
+            buffer.Batches.Clear();
+            _isWriting = false;
+            _idleSignal.NotifyAll();
+        }
+        results.Clear();
+    }
+
+    ScopeLock lock(_locker);
+    _idleSignal.NotifyAll();
+    return 0;
+}
+
+void SteamSaveGameWorker::Stop()
+{
+    ScopeLock lock(_locker);
+    _exitRequested = true;
+    _workSignal.NotifyAll();
+}
+
+#endif
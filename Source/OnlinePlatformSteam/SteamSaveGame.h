@@ -0,0 +1,132 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_MAC
+
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Platform/ConditionVariable.h"
+#include "Engine/Threading/IRunnable.h"
+
+class Thread;
+class ISteamRemoteStorage;
+struct SteamSaveGameFile;
+
+/// <summary>
+/// Steam Remote Storage helpers used for cloud savegames.
+/// </summary>
+namespace SteamSaveGame
+{
+    /// <summary>
+    /// Reads the savegame file contents. Missing file results in empty data. Compressed savegames are decompressed directly into the output data.
+    /// </summary>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Read(ISteamRemoteStorage* remoteStorage, const StringView& name, Array<byte>& data);
+
+    /// <summary>
+    /// Writes the savegame file contents. Empty data deletes the file.
+    /// </summary>
+    /// <param name="remoteStorage">The Steam Remote Storage interface.</param>
+    /// <param name="name">The savegame name.</param>
+    /// <param name="data">The savegame contents.</param>
+    /// <param name="compressionThreshold">The minimum data size (in bytes) to compress the savegame. Negative value disables compression.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Write(ISteamRemoteStorage* remoteStorage, const StringView& name, const Span<byte>& data, int32 compressionThreshold = -1);
+}
+
+/// <summary>
+/// Background worker that writes savegames to Steam Remote Storage. Uses a double-buffered set of pending writes: the game thread copies data into the back buffer and returns, the worker swaps buffers and writes the front one. Multiple writes to the same slot are merged so only the latest data gets written.
+/// </summary>
+class SteamSaveGameWorker : public IRunnable
+{
+public:
+    struct BatchResult
+    {
+        uint32 Id;
+        bool Failed;
+    };
+
+private:
+    struct PendingBatch
+    {
+        uint32 Id;
+        Array<String> Files;
+    };
+
+    struct PendingWrites
+    {
+        Dictionary<String, Array<byte>> Files;
+        Array<PendingBatch> Batches;
+    };
+
+    ISteamRemoteStorage* _remoteStorage;
+    int32 _compressionThreshold;
+    Thread* _thread = nullptr;
+    CriticalSection _locker;
+    ConditionVariable _workSignal;
+    ConditionVariable _idleSignal;
+    PendingWrites _buffers[2];
+    Array<BatchResult> _results;
+    int32 _backBuffer = 0;
+    bool _isWriting = false;
+    bool _exitRequested = false;
+
+public:
+    SteamSaveGameWorker(ISteamRemoteStorage* remoteStorage, int32 compressionThreshold);
+    ~SteamSaveGameWorker();
+
+public:
+    /// <summary>
+    /// Starts the worker thread.
+    /// </summary>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Start();
+
+    /// <summary>
+    /// Writes all pending savegames and stops the worker thread.
+    /// </summary>
+    void Shutdown();
+
+    /// <summary>
+    /// Queues the savegame write (copies the data). Replaces any pending write to the same slot.
+    /// </summary>
+    void Enqueue(const StringView& name, const Span<byte>& data);
+
+    /// <summary>
+    /// Queues the batch of savegame writes (copies the data). All files are written within a single Steam Remote Storage write batch so the set stays consistent in the cloud.
+    /// </summary>
+    /// <param name="id">The batch identifier reported back via PopCompletedBatches.</param>
+    /// <param name="files">The savegame files.</param>
+    void EnqueueBatch(uint32 id, const Array<SteamSaveGameFile>& files);
+
+    /// <summary>
+    /// Moves the results of the written batches into the given list.
+    /// </summary>
+    void PopCompletedBatches(Array<BatchResult>& results);
+
+    /// <summary>
+    /// Gets the data of the pending (not yet written) savegame.
+    /// </summary>
+    /// <returns>True if savegame has pending write and data was copied, otherwise false.</returns>
+    bool TryGetPending(const StringView& name, Array<byte>& data);
+
+    /// <summary>
+    /// Blocks until all pending savegames get written.
+    /// </summary>
+    void Flush();
+
+public:
+    // [IRunnable]
+    String ToString() const override
+    {
+        return TEXT("SteamSaveGameWorker");
+    }
+    int32 Run() override;
+    void Stop() override;
+};
+
+#endif